@@ -0,0 +1,98 @@
+#include "ballDraw.h"
+
+const Color ballPalette[BALL_MAX_COLORS] = {RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE};
+
+void DrawStripedBall(const Ball *ball) {
+    for (int i = 0; i < BALL_MAX_COLORS; i++) {
+        float angleStart = ball->rotation + (i * 360.0f / BALL_MAX_COLORS); // Start angle for the stripe
+        float angleEnd = angleStart + (360.0f / BALL_MAX_COLORS);          // End angle for the stripe
+        DrawCircleSector(ball->position, BALL_RADIUS, angleStart, angleEnd, 10, ballPalette[(ball->paletteOffset + i) % BALL_MAX_COLORS]);
+    }
+}
+
+void DrawBallStore(const BallStore *store) {
+    const float stripe = 360.0f / BALL_MAX_COLORS;
+    for (int i = 0; i < store->count; i++) {
+        Vector2 position = {store->x[i], store->y[i]};
+        for (int k = 0; k < BALL_MAX_COLORS; k++) {
+            float angleStart = store->rotation[i] + k * stripe;
+            Color color = ballPalette[(store->paletteOffset[i] + k) % BALL_MAX_COLORS];
+            DrawCircleSector(position, BALL_RADIUS, angleStart, angleStart + stripe, 10, color);
+        }
+    }
+}
+
+Texture2D LoadBallAtlasTexture(const BallAtlas *atlas) {
+    Image image = {atlas->image.pixels, atlas->image.width, atlas->image.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+    return LoadTextureFromImage(image);
+}
+
+static void DrawAtlasCell(Texture2D texture, const BallAtlas *atlas, float x, float y, float rotation, int paletteOffset) {
+    int cellX, cellY;
+    BallAtlasCell(atlas, rotation, paletteOffset, &cellX, &cellY);
+    float half = atlas->cellSize / 2.0f;
+    Rectangle source = {(float)cellX, (float)cellY, (float)atlas->cellSize, (float)atlas->cellSize};
+    DrawTextureRec(texture, source, (Vector2){x - half, y - half}, WHITE);
+}
+
+void DrawStripedBallAtlas(Texture2D texture, const BallAtlas *atlas, const Ball *ball) {
+    DrawAtlasCell(texture, atlas, ball->position.x, ball->position.y, ball->rotation, ball->paletteOffset);
+}
+
+void DrawBallStoreAtlas(Texture2D texture, const BallAtlas *atlas, const BallStore *store) {
+    for (int i = 0; i < store->count; i++) {
+        DrawAtlasCell(texture, atlas, store->x[i], store->y[i], store->rotation[i], store->paletteOffset[i]);
+    }
+}
+
+#define OVERLAY_BUCKETS 40             // 1 ms each; the last holds every slower frame
+#define OVERLAY_GRAPH_HEIGHT 70
+
+static const Color phaseColors[FRAME_PHASE_COUNT] = {SKYBLUE, LIME, ORANGE, VIOLET, GRAY};
+
+void DrawFrameStatsOverlay(const FrameStats *stats, int x, int y) {
+    FrameSummary summary;
+    FrameStatsSummarize(stats, &summary);
+    DrawRectangle(x, y, FRAME_OVERLAY_WIDTH, FRAME_OVERLAY_HEIGHT, Fade(BLACK, 0.75f));
+    x += 5;
+    y += 5;
+
+    DrawText(TextFormat("Frame p50 %.1f  p95 %.1f  p99 %.1f  worst %.1f ms", summary.p50 * 1000.0,
+                        summary.p95 * 1000.0, summary.p99 * 1000.0, summary.worst * 1000.0),
+             x, y, 10, RAYWHITE);
+    DrawText(TextFormat("%d frames, mean %.2f ms (%.0f fps)", summary.frames, summary.mean * 1000.0,
+                        summary.mean > 0.0 ? 1.0 / summary.mean : 0.0),
+             x, y + 14, 10, RAYWHITE);
+
+    // Histogram, scaled to its tallest bucket
+    int counts[OVERLAY_BUCKETS];
+    int largest = FrameStatsHistogram(stats, counts, OVERLAY_BUCKETS, 0.001);
+    int barWidth = (FRAME_OVERLAY_WIDTH - 10) / OVERLAY_BUCKETS;
+    int base = y + 32 + OVERLAY_GRAPH_HEIGHT;
+    for (int bucket = 0; bucket < OVERLAY_BUCKETS && largest > 0; bucket++) {
+        int height = (counts[bucket] * OVERLAY_GRAPH_HEIGHT + largest - 1) / largest;
+        Color color = bucket < 17 ? GREEN : bucket < 33 ? ORANGE : RED;
+        DrawRectangle(x + bucket * barWidth, base - height, barWidth - 1, height, color);
+    }
+    DrawLine(x, base, x + OVERLAY_BUCKETS * barWidth, base, LIGHTGRAY);
+    DrawText("0", x, base + 2, 10, LIGHTGRAY);
+    DrawText("16.7", x + 16 * barWidth, base + 2, 10, LIGHTGRAY);
+    DrawText("33.3", x + 32 * barWidth, base + 2, 10, LIGHTGRAY);
+    DrawText(TextFormat("%d+ ms", OVERLAY_BUCKETS - 1), x + (OVERLAY_BUCKETS - 3) * barWidth, base + 2, 10, LIGHTGRAY);
+
+    // Phases: one bar split by mean time, then a legend
+    int barY = base + 16;
+    double total = 0.0;
+    for (int phase = 0; phase < FRAME_PHASE_COUNT; phase++) total += summary.phases[phase];
+    int left = x;
+    for (int phase = 0; phase < FRAME_PHASE_COUNT && total > 0.0; phase++) {
+        int width = (int)(summary.phases[phase] / total * (FRAME_OVERLAY_WIDTH - 10) + 0.5);
+        DrawRectangle(left, barY, width, 8, phaseColors[phase]);
+        left += width;
+    }
+    for (int phase = 0; phase < FRAME_PHASE_COUNT; phase++) {
+        int column = phase % 3, row = phase / 3;
+        DrawText(TextFormat("%s %.3f ms", framePhaseNames[phase], summary.phases[phase] * 1000.0),
+                 x + column * 108, barY + 12 + row * 14, 10, phaseColors[phase]);
+    }
+}
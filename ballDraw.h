@@ -0,0 +1,39 @@
+#ifndef BALL_DRAW_H
+#define BALL_DRAW_H
+
+// raylib drawing for the core Ball and the frame statistics overlay, shared
+// by the windowed front-ends. Include raylib.h before this header (and
+// before any core header).
+#include "raylib.h"
+#include "ball.h"
+#include "ballAtlas.h"
+#include "ballStore.h"
+#include "frameStats.h"
+
+#define FRAME_OVERLAY_WIDTH 330
+#define FRAME_OVERLAY_HEIGHT 180
+
+// Colour of each palette index (see Ball.paletteOffset)
+extern const Color ballPalette[BALL_MAX_COLORS];
+
+// Draw the ball as BALL_MAX_COLORS circle sectors starting at its rotation
+void DrawStripedBall(const Ball *ball);
+
+// Draw every ball of a store the same way
+void DrawBallStore(const BallStore *store);
+
+// Upload a BallAtlas image as a texture (after InitWindow)
+Texture2D LoadBallAtlasTexture(const BallAtlas *atlas);
+
+// Draw the ball / every ball of a store as one textured quad from the atlas;
+// raylib batches consecutive quads of one texture into a single draw call
+void DrawStripedBallAtlas(Texture2D texture, const BallAtlas *atlas, const Ball *ball);
+void DrawBallStoreAtlas(Texture2D texture, const BallAtlas *atlas, const BallStore *store);
+
+// Draw the frame statistics on a dark panel with its top-left corner at
+// (x, y): p50 / p95 / p99 / worst frame time, a histogram of the window's
+// frame times in 1 ms buckets (green within one 60 Hz frame, orange within
+// two, red beyond) and the mean time of each phase
+void DrawFrameStatsOverlay(const FrameStats *stats, int x, int y);
+
+#endif // BALL_DRAW_H
@@ -0,0 +1,110 @@
+#include "ball.h"
+
+void InitBall(Ball *ball) {
+    ball->position = (Vector2){0, SCREEN_HEIGHT / 2};
+    ball->rotation = 0;
+    ball->paletteOffset = 0;
+    ball->velocity = BALL_START_VELOCITY;
+    ball->t = 0.0f;
+    ball->directionRight = true;
+}
+
+void InitBallCrowd(Ball *balls, int count) {
+    for (int i = 0; i < count; i++) {
+        InitBall(&balls[i]);
+        balls[i].t = (float)i / count;
+        balls[i].velocity = BALL_START_VELOCITY * (0.5f + 0.1f * (i % 10));
+        balls[i].rotation = (float)((i * 37) % 360);
+        balls[i].directionRight = (i % 2) == 0;
+    }
+}
+
+void InitRacket(Racket *racket) {
+    racket->x = SCREEN_WIDTH - RACKET_WIDTH - 10;
+    racket->y = SCREEN_HEIGHT / 2 - RACKET_HEIGHT / 2;
+    racket->width = RACKET_WIDTH;
+    racket->height = RACKET_HEIGHT;
+}
+
+void AdvanceBall(Ball *ball, PathFunction path) {
+    ball->t += (ball->directionRight ? ball->velocity : -ball->velocity);
+    if (ball->t > 1.0f) ball->t = 0.0f; // Reset to left edge
+    if (ball->t < 0.0f) ball->t = 1.0f; // Reset to right edge
+
+    ball->position = path(ball->t);
+    ball->rotation += BALL_ROTATION_STEP;
+}
+
+int UpdateBall(Ball *ball, PathFunction path, const Racket *racket) {
+    int events = 0;
+    float t0 = ball->t;
+    int pathId = PathIdOf(path);
+
+    AdvanceBall(ball, path);
+
+    // Moving right, sweep the step (up to t = 1 if it wrapped) so a fast
+    // ball cannot pass the racket between two updates, and put the ball
+    // where it first touched it
+    bool hit;
+    if (ball->directionRight && pathId >= 0) {
+        float t1 = ball->t < t0 ? 1.0f : ball->t;
+        float tHit = SweepCircleRacket(pathId, t0, t1, BALL_RADIUS, racket);
+        hit = tHit >= 0.0f;
+        if (hit) {
+            ball->t = tHit;
+            ball->position = path(tHit);
+        }
+    } else {
+        hit = CircleHitsRacket(ball->position, BALL_RADIUS, racket);
+    }
+
+    if (hit) {
+        ball->position.x = racket->x - BALL_RADIUS; // Adjust position to avoid overlap
+        ball->directionRight = false;
+        ball->velocity += BALL_VELOCITY_STEP;
+        RotateBallColorsLeft(ball);
+        events |= BALL_EVENT_RACKET;
+    }
+
+    if (CircleHitsLeftWall(ball->position, BALL_RADIUS)) {
+        ball->directionRight = true;
+        RotateBallColorsRight(ball);
+        events |= BALL_EVENT_WALL;
+    }
+    return events;
+}
+
+typedef struct {
+    Ball *balls;
+    PathFunction path;
+    const Racket *racket;
+    int racketHits;
+} UpdateBallsJob;
+
+static void UpdateBallRange(void *context, int begin, int end) {
+    UpdateBallsJob *job = context;
+    int hits = 0;
+    for (int i = begin; i < end; i++) {
+        if (UpdateBall(&job->balls[i], job->path, job->racket) & BALL_EVENT_RACKET) hits++;
+    }
+    if (hits > 0) __atomic_add_fetch(&job->racketHits, hits, __ATOMIC_RELAXED);
+}
+
+int UpdateBalls(JobSystem *jobs, Ball *balls, int count, PathFunction path, const Racket *racket) {
+    UpdateBallsJob job = {balls, path, racket, 0};
+    JobSystemParallelFor(jobs, count, BALL_UPDATE_GRAIN, UpdateBallRange, &job);
+    return job.racketHits;
+}
+
+void RotateBallColorsLeft(Ball *ball) {
+    ball->paletteOffset = (ball->paletteOffset + 1) % BALL_MAX_COLORS;
+}
+
+void RotateBallColorsRight(Ball *ball) {
+    ball->paletteOffset = (ball->paletteOffset + BALL_MAX_COLORS - 1) % BALL_MAX_COLORS;
+}
+
+void MoveRacket(Racket *racket, float dy) {
+    if (dy < 0 && racket->y > 0) racket->y += dy;
+    if (dy > 0 && racket->y + racket->height < SCREEN_HEIGHT) racket->y += dy;
+}
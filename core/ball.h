@@ -0,0 +1,72 @@
+#ifndef BALL_H
+#define BALL_H
+
+#include <stdbool.h>
+#include "collision.h"
+#include "jobSystem.h"
+#include "paths.h"
+
+// Ball state and the per-frame game rules, without any drawing.
+// Stripe colours are palette indices; each front-end maps them to its own
+// colour type.
+
+#define BALL_RADIUS 30
+#define BALL_MAX_COLORS 6
+#define BALL_ROTATION_STEP 5.0f     // Degrees per update
+#define BALL_START_VELOCITY 0.01f   // t per update
+#define BALL_VELOCITY_STEP 0.001f   // Added on every racket hit
+
+#define RACKET_WIDTH 10
+#define RACKET_HEIGHT 100
+#define RACKET_SPEED 400.0f         // Pixels per second
+
+#define BALL_UPDATE_GRAIN 256       // Balls per job in UpdateBalls
+
+// UpdateBall result flags
+#define BALL_EVENT_RACKET 1
+#define BALL_EVENT_WALL 2
+
+typedef struct {
+    Vector2 position;                       // Current position of the ball
+    float rotation;                         // Rotation angle for the stripes
+    int paletteOffset;                      // Stripe k uses palette index (paletteOffset + k) % BALL_MAX_COLORS
+    float velocity;                         // Step in t per update
+    float t;                                // Position along the path
+    bool directionRight;                    // Moving towards t = 1
+} Ball;
+
+void InitBall(Ball *ball);
+
+// InitBall for `count` balls spread evenly along t, with speeds between 0.5x
+// and 1.4x BALL_START_VELOCITY and staggered stripe rotations, so a crowd
+// does not move as one clump
+void InitBallCrowd(Ball *balls, int count);
+void InitRacket(Racket *racket);
+
+// Step t by the velocity (wrapping at the screen edges), move the ball along
+// `path` and spin it
+void AdvanceBall(Ball *ball, PathFunction path);
+
+// AdvanceBall plus racket and left wall collisions: a racket hit bounces the
+// ball back, speeds it up and rotates the colours one way, a wall hit sends
+// it right again and rotates them back. Returns BALL_EVENT_* flags.
+// For the functions of pathFunctions / pathFunctionsAsm a ball moving right
+// is swept against the racket (SweepCircleRacket) and stops at the first
+// contact; other path functions and balls moving left are tested at the
+// new position only.
+int UpdateBall(Ball *ball, PathFunction path, const Racket *racket);
+
+// UpdateBall for every ball, spread over the job system in chunks of
+// BALL_UPDATE_GRAIN. Balls are independent, so the result does not depend
+// on the number of workers. Returns the number of racket hits.
+int UpdateBalls(JobSystem *jobs, Ball *balls, int count, PathFunction path, const Racket *racket);
+
+// Shift every stripe to the next / previous palette colour. This only moves
+// paletteOffset, which is also the row of the ball in a BallAtlas.
+void RotateBallColorsLeft(Ball *ball);
+void RotateBallColorsRight(Ball *ball);
+
+// Move the racket by dy pixels if it stays on screen
+void MoveRacket(Racket *racket, float dy);
+
+#endif // BALL_H
@@ -0,0 +1,166 @@
+#include "ballAtlas.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BALL_ATLAS_X86 1
+#endif
+
+#define ATLAS_STRIPE_DEGREES (360.0f / BALL_MAX_COLORS)
+
+// Render one cell: colours come from a ball two pixels larger, so the edge
+// pixels get their stripe colour at full strength, and alpha from a white
+// ball of the real size drawn over transparent black
+static void RenderCell(BallAtlas *atlas, Framebuffer *coverage, int x0, int y0, float rotation,
+                       const unsigned int colors[BALL_MAX_COLORS]) {
+    unsigned int white[BALL_MAX_COLORS];
+    for (int k = 0; k < BALL_MAX_COLORS; k++) {
+        white[k] = 0xffffffffu;
+    }
+    const int cellSize = atlas->cellSize;
+    const float center = cellSize / 2.0f;
+    RasterBall ball;
+
+    FramebufferClear(coverage, 0);
+    RasterBallInit(&ball, center, center, BALL_RADIUS, rotation, white);
+    SoftDrawRasterBall(coverage, &ball);
+
+    RasterBallInit(&ball, x0 + center, y0 + center, BALL_RADIUS + 2.0f, rotation, colors);
+    SoftDrawRasterBallClipped(&atlas->image, &ball, x0, y0, x0 + cellSize, y0 + cellSize);
+
+    for (int y = 0; y < cellSize; y++) {
+        unsigned int *row = atlas->image.pixels + (size_t)(y0 + y) * (size_t)atlas->image.width + x0;
+        const unsigned int *alpha = coverage->pixels + (size_t)y * (size_t)cellSize;
+        for (int x = 0; x < cellSize; x++) {
+            row[x] = (alpha[x] & 0xff000000u) ? (row[x] & 0x00ffffffu) | (alpha[x] & 0xff000000u) : 0;
+        }
+    }
+}
+
+bool BallAtlasInit(BallAtlas *atlas, float stepDegrees, const unsigned int palette[BALL_MAX_COLORS]) {
+    int columns = (int)floorf(ATLAS_STRIPE_DEGREES / stepDegrees + 0.5f);
+    if (columns < 1) columns = 1;
+    atlas->columns = columns;
+    atlas->stepDegrees = ATLAS_STRIPE_DEGREES / columns;
+    atlas->cellSize = 2 * (BALL_RADIUS + 2);
+
+    Framebuffer coverage;
+    if (!FramebufferInit(&atlas->image, columns * atlas->cellSize, BALL_MAX_COLORS * atlas->cellSize)) return false;
+    if (!FramebufferInit(&coverage, atlas->cellSize, atlas->cellSize)) {
+        BallAtlasFree(atlas);
+        return false;
+    }
+    FramebufferClear(&atlas->image, 0);
+
+    for (int row = 0; row < BALL_MAX_COLORS; row++) {
+        unsigned int colors[BALL_MAX_COLORS];
+        for (int k = 0; k < BALL_MAX_COLORS; k++) {
+            colors[k] = palette[(row + k) % BALL_MAX_COLORS];
+        }
+        for (int column = 0; column < columns; column++) {
+            RenderCell(atlas, &coverage, column * atlas->cellSize, row * atlas->cellSize,
+                       column * atlas->stepDegrees, colors);
+        }
+    }
+    FramebufferFree(&coverage);
+    return true;
+}
+
+void BallAtlasFree(BallAtlas *atlas) {
+    FramebufferFree(&atlas->image);
+    memset(atlas, 0, sizeof(*atlas));
+}
+
+void BallAtlasCell(const BallAtlas *atlas, float rotation, int paletteOffset, int *x, int *y) {
+    const int frames = atlas->columns * BALL_MAX_COLORS;  // Steps in a full turn
+    int step = (int)floorf(fmodf(rotation, 360.0f) / atlas->stepDegrees + 0.5f) % frames;
+    if (step < 0) step += frames;
+
+    // Each whole stripe of rotation is one palette offset back
+    int row = (paletteOffset - step / atlas->columns) % BALL_MAX_COLORS;
+    if (row < 0) row += BALL_MAX_COLORS;
+    *x = step % atlas->columns * atlas->cellSize;
+    *y = row * atlas->cellSize;
+}
+
+// Straight alpha over for one pixel, keeping the destination alpha
+static unsigned int BlendPixel(unsigned int dst, unsigned int color) {
+    unsigned int a = color >> 24;
+    if (a == 255) return color;
+    if (a == 0) return dst;
+    a += a >> 7;  // [0, 256]
+    unsigned int rb = ((color & 0x00ff00ffu) * a + (dst & 0x00ff00ffu) * (256 - a)) >> 8;
+    unsigned int g = ((color & 0x0000ff00u) * a + (dst & 0x0000ff00u) * (256 - a)) >> 8;
+    return (rb & 0x00ff00ffu) | (g & 0x0000ff00u) | (dst & 0xff000000u);
+}
+
+#ifdef BALL_ATLAS_X86
+
+// BlendPixel four pixels at a time in 16-bit lanes, skipping the
+// transparent corners and copying the opaque middle of the cell
+__attribute__((target("sse2")))
+static void BlendRow(unsigned int *dst, const unsigned int *src, int count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32((int)0xff000000u);
+    const __m128i full = _mm_set1_epi16(256);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i color = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i alpha = _mm_and_si128(color, alphaMask);
+        int opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask));
+        if (opaque == 0xffff) {
+            _mm_storeu_si128((__m128i *)(dst + i), color);
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) == 0xffff) continue;
+
+        __m128i back = _mm_loadu_si128((const __m128i *)(dst + i));
+        __m128i a = _mm_srli_epi32(color, 24);
+        a = _mm_add_epi32(a, _mm_srli_epi32(a, 7));
+        a = _mm_or_si128(a, _mm_slli_epi32(a, 16));  // a in both 16-bit halves
+        __m128i aLow = _mm_unpacklo_epi32(a, a);
+        __m128i aHigh = _mm_unpackhi_epi32(a, a);
+        __m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(color, zero), aLow),
+                                    _mm_mullo_epi16(_mm_unpacklo_epi8(back, zero), _mm_sub_epi16(full, aLow)));
+        __m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(color, zero), aHigh),
+                                     _mm_mullo_epi16(_mm_unpackhi_epi8(back, zero), _mm_sub_epi16(full, aHigh)));
+        __m128i blended = _mm_packus_epi16(_mm_srli_epi16(low, 8), _mm_srli_epi16(high, 8));
+        blended = _mm_or_si128(_mm_andnot_si128(alphaMask, blended), _mm_and_si128(back, alphaMask));
+        _mm_storeu_si128((__m128i *)(dst + i), blended);
+    }
+    for (; i < count; i++) {
+        dst[i] = BlendPixel(dst[i], src[i]);
+    }
+}
+
+#else
+
+static void BlendRow(unsigned int *dst, const unsigned int *src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = BlendPixel(dst[i], src[i]);
+    }
+}
+
+#endif // BALL_ATLAS_X86
+
+void BallAtlasBlit(Framebuffer *framebuffer, const BallAtlas *atlas, float centerX, float centerY,
+                   float rotation, int paletteOffset) {
+    const int cellSize = atlas->cellSize;
+    int cellX, cellY;
+    BallAtlasCell(atlas, rotation, paletteOffset, &cellX, &cellY);
+
+    int left = (int)floorf(centerX - cellSize / 2.0f + 0.5f);
+    int top = (int)floorf(centerY - cellSize / 2.0f + 0.5f);
+    int x0 = left < 0 ? 0 : left, y0 = top < 0 ? 0 : top;
+    int x1 = left + cellSize < framebuffer->width ? left + cellSize : framebuffer->width;
+    int y1 = top + cellSize < framebuffer->height ? top + cellSize : framebuffer->height;
+    if (x1 <= x0) return;
+
+    for (int y = y0; y < y1; y++) {
+        const unsigned int *src = atlas->image.pixels + (size_t)(cellY + y - top) * (size_t)atlas->image.width
+                                  + (cellX + x0 - left);
+        BlendRow(framebuffer->pixels + (size_t)y * (size_t)framebuffer->width + x0, src, x1 - x0);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef BALL_ATLAS_H
+#define BALL_ATLAS_H
+
+#include <stdbool.h>
+#include "ball.h"
+#include "softRaster.h"
+
+// Pre-rendered striped balls.
+//
+// A ball's look depends only on its rotation and palette offset, and
+// rotation moves in fixed steps (BALL_ROTATION_STEP), so every look can be
+// rendered once with the software rasterizer and then copied. Turning a
+// ball by one stripe (360 / BALL_MAX_COLORS degrees) gives the same image
+// as moving its palette offset back by one, so only rotations in
+// [0, 360 / BALL_MAX_COLORS) need frames:
+//   column  rotation step within one stripe
+//   row     palette offset, after folding in whole stripes of rotation
+// With 5 degree steps that is 12 columns by 6 rows of 64 x 64 cells.
+//
+// Pixels are straight (not premultiplied) RGBA8 with coverage in alpha, so
+// the image can be uploaded as a texture and drawn with normal alpha
+// blending, or copied with BallAtlasBlit. Rotations between steps round to
+// the nearest frame, and blits land on whole pixels.
+
+typedef struct {
+    Framebuffer image;   // columns * cellSize by BALL_MAX_COLORS * cellSize
+    int cellSize;        // Ball centre at (cellSize / 2, cellSize / 2) of a cell
+    int columns;         // Frames per stripe
+    float stepDegrees;   // Rotation between columns
+} BallAtlas;
+
+// Render the atlas for `stepDegrees` (e.g. BALL_ROTATION_STEP) with
+// `palette` (RGBA per palette index, e.g. softBallPalette). The step is
+// rounded so a whole number of frames fits in one stripe.
+bool BallAtlasInit(BallAtlas *atlas, float stepDegrees, const unsigned int palette[BALL_MAX_COLORS]);
+void BallAtlasFree(BallAtlas *atlas);
+
+// Cell holding a ball with `rotation` (degrees, any range) and
+// `paletteOffset`; x and y are the cell's top-left pixel in the image
+void BallAtlasCell(const BallAtlas *atlas, float rotation, int paletteOffset, int *x, int *y);
+
+// Alpha-blend the cell for (rotation, paletteOffset) centred on
+// (centerX, centerY), clipped to the framebuffer
+void BallAtlasBlit(Framebuffer *framebuffer, const BallAtlas *atlas, float centerX, float centerY,
+                   float rotation, int paletteOffset);
+
+#endif // BALL_ATLAS_H
@@ -0,0 +1,359 @@
+#include "ballStore.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fastSin.h"
+#include "trace.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BALL_STORE_SSE2 1
+#endif
+
+#define BALL_STORE_ALIGN 64
+#define BALL_STORE_BLOCK 256  // Balls per update block, sized for L1
+#define BALL_STORE_GRAIN 1024 // Balls per job, a whole number of blocks
+
+#define BALL_STORE_PI 3.14159265358979323846f
+
+// Every path is y = mid + amp * sin(freq * t) + (t < 0.5 ? -step : step),
+// so the update loop needs no per-ball branch on the path
+static const float pathAmp[PATH_COUNT] = {0.0f, 0.0f, -200.0f, 100.0f};
+static const float pathFreq[PATH_COUNT] = {0.0f, 0.0f, BALL_STORE_PI, 4.0f * BALL_STORE_PI};
+static const float pathStep[PATH_COUNT] = {0.0f, 100.0f, 0.0f, 0.0f};
+
+// Aligned block of at least `bytes`, rounded up to whole cache lines
+static void *AllocAligned(size_t bytes) {
+    size_t rounded = (bytes + BALL_STORE_ALIGN - 1) / BALL_STORE_ALIGN * BALL_STORE_ALIGN;
+    return aligned_alloc(BALL_STORE_ALIGN, rounded > 0 ? rounded : BALL_STORE_ALIGN);
+}
+
+// Replace *array with a larger aligned copy of its first `count` elements
+static bool GrowArray(void **array, size_t elementSize, int count, int capacity) {
+    void *grown = AllocAligned(elementSize * (size_t)capacity);
+    if (grown == NULL) return false;
+    if (*array != NULL) memcpy(grown, *array, elementSize * (size_t)count);
+    free(*array);
+    *array = grown;
+    return true;
+}
+
+bool BallStoreInit(BallStore *store, int capacity) {
+    memset(store, 0, sizeof(*store));
+    return BallStoreReserve(store, capacity > 0 ? capacity : 1);
+}
+
+void BallStoreFree(BallStore *store) {
+    free(store->x);
+    free(store->y);
+    free(store->t);
+    free(store->velocity);
+    free(store->rotation);
+    free(store->pathId);
+    free(store->paletteOffset);
+    free(store->denseToSlot);
+    free(store->slotToDense);
+    free(store->generations);
+    free(store->freeSlots);
+    memset(store, 0, sizeof(*store));
+}
+
+bool BallStoreReserve(BallStore *store, int capacity) {
+    if (capacity <= store->capacity) return true;
+
+    // Grow geometrically so repeated small spawns stay amortised O(1)
+    if (capacity < store->capacity * 2) capacity = store->capacity * 2;
+    int count = store->count;
+    int slots = store->slotCount;
+    bool ok = GrowArray((void **)&store->x, sizeof(float), count, capacity) &&
+              GrowArray((void **)&store->y, sizeof(float), count, capacity) &&
+              GrowArray((void **)&store->t, sizeof(float), count, capacity) &&
+              GrowArray((void **)&store->velocity, sizeof(float), count, capacity) &&
+              GrowArray((void **)&store->rotation, sizeof(float), count, capacity) &&
+              GrowArray((void **)&store->pathId, 1, count, capacity) &&
+              GrowArray((void **)&store->paletteOffset, 1, count, capacity) &&
+              GrowArray((void **)&store->denseToSlot, sizeof(unsigned int), count, capacity) &&
+              GrowArray((void **)&store->slotToDense, sizeof(int), slots, capacity) &&
+              GrowArray((void **)&store->generations, sizeof(unsigned int), slots, capacity) &&
+              GrowArray((void **)&store->freeSlots, sizeof(int), store->freeCount, capacity);
+    if (!ok) return false;  // Arrays grown so far are valid, just larger
+    store->capacity = capacity;
+    return true;
+}
+
+int BallStoreSpawn(BallStore *store, int count, int path, BallHandle *handles) {
+    if (count <= 0) return store->count;
+    if (!BallStoreReserve(store, store->count + count)) return -1;
+
+    int first = store->count;
+    for (int i = first; i < first + count; i++) {
+        // Reuse a freed slot when there is one, so the slot table stays
+        // no larger than the peak ball count
+        int slot;
+        if (store->freeCount > 0) {
+            slot = store->freeSlots[--store->freeCount];
+        } else {
+            slot = store->slotCount++;
+            store->generations[slot] = 0;
+        }
+        store->slotToDense[slot] = i;
+        store->denseToSlot[i] = (unsigned)slot;
+        if (handles != NULL) handles[i - first] = (BallHandle){(unsigned)slot, store->generations[slot]};
+
+        store->x[i] = 0.0f;
+        store->y[i] = SCREEN_HEIGHT / 2;
+        store->t[i] = 0.0f;
+        store->velocity[i] = BALL_START_VELOCITY;
+        store->rotation[i] = 0.0f;
+        store->pathId[i] = (unsigned char)path;
+        store->paletteOffset[i] = 0;
+    }
+    store->count += count;
+    return first;
+}
+
+void BallStoreSpreadCrowd(BallStore *store, int first, int count) {
+    for (int i = 0; i < count; i++) {
+        int index = first + i;
+        float speed = BALL_START_VELOCITY * (0.5f + 0.1f * (i % 10));
+        store->t[index] = (float)i / count;
+        store->velocity[index] = (i % 2) == 0 ? speed : -speed;
+        store->rotation[index] = (float)((i * 37) % 360);
+    }
+}
+
+bool BallStoreResizeCrowd(BallStore *store, int count) {
+    if (count > store->count) {
+        int first = store->count;
+        int added = count - first;
+        for (int path = 0; path < PATH_COUNT; path++) {
+            if (BallStoreSpawn(store, added / PATH_COUNT + (path < added % PATH_COUNT), path, NULL) < 0) return false;
+        }
+        BallStoreSpreadCrowd(store, first, added);
+    } else {
+        // Despawning the last ball moves nothing, so go from the end
+        while (store->count > count) {
+            BallHandle handle = BallStoreHandle(store, store->count - 1);
+            BallStoreDespawn(store, &handle, 1);
+        }
+    }
+    return true;
+}
+
+int BallStoreDespawn(BallStore *store, const BallHandle *handles, int count) {
+    int removed = 0;
+    for (int h = 0; h < count; h++) {
+        int index = BallStoreIndex(store, handles[h]);
+        if (index < 0) continue;
+
+        // Move the last ball into the hole and repoint its slot
+        int last = store->count - 1;
+        unsigned int slot = handles[h].slot;
+        if (index != last) {
+            unsigned int lastSlot = store->denseToSlot[last];
+            store->x[index] = store->x[last];
+            store->y[index] = store->y[last];
+            store->t[index] = store->t[last];
+            store->velocity[index] = store->velocity[last];
+            store->rotation[index] = store->rotation[last];
+            store->pathId[index] = store->pathId[last];
+            store->paletteOffset[index] = store->paletteOffset[last];
+            store->denseToSlot[index] = lastSlot;
+            store->slotToDense[lastSlot] = index;
+        }
+        store->slotToDense[slot] = -1;
+        store->generations[slot]++;
+        store->freeSlots[store->freeCount++] = (int)slot;
+        store->count--;
+        removed++;
+    }
+    return removed;
+}
+
+int BallStoreIndex(const BallStore *store, BallHandle handle) {
+    if (handle.slot >= (unsigned)store->slotCount) return -1;
+    if (store->generations[handle.slot] != handle.generation) return -1;
+    return store->slotToDense[handle.slot];
+}
+
+BallHandle BallStoreHandle(const BallStore *store, int index) {
+    unsigned int slot = store->denseToSlot[index];
+    return (BallHandle){slot, store->generations[slot]};
+}
+
+typedef struct {
+    BallStore *store;
+    const Racket *racket;
+    int racketHits;
+} BallStoreUpdateJob;
+
+static float PathY(int path, float t) {
+    float side = t < 0.5f ? -pathStep[path] : pathStep[path];
+    return SCREEN_HEIGHT / 2.0f + pathAmp[path] * FastSinf(t * pathFreq[path]) + side;
+}
+
+// Update one block (begin is a multiple of 4, so the SSE loads are aligned):
+// a pass that streams t/velocity/pathId in and x/y/rotation
+// out, the batched racket test, a sweep for the balls moving right near the
+// racket, then a pass that only branches for the few balls that bounced
+static int UpdateBlock(BallStore *store, const Racket *racket, int begin, int end) {
+    float *restrict x = store->x;
+    float *restrict y = store->y;
+    float *restrict t = store->t;
+    float *restrict velocity = store->velocity;
+    float *restrict rotation = store->rotation;
+    const unsigned char *restrict pathId = store->pathId;
+    unsigned char *restrict paletteOffset = store->paletteOffset;
+    unsigned char hits[BALL_STORE_BLOCK];
+    int racketHits = 0;
+
+    int i = begin;
+#ifdef BALL_STORE_SSE2
+    // Four balls at a time; the per-path coefficients are picked with
+    // compare masks on the path id instead of a table gather
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 full = _mm_set1_ps(360.0f);
+    for (; i + 4 <= end; i += 4) {
+        __m128 ti = _mm_add_ps(_mm_load_ps(t + i), _mm_load_ps(velocity + i));
+        ti = _mm_andnot_ps(_mm_cmpgt_ps(ti, one), ti);
+        __m128 wrapped = _mm_cmplt_ps(ti, zero);
+        ti = _mm_or_ps(_mm_and_ps(wrapped, one), _mm_andnot_ps(wrapped, ti));
+        _mm_store_ps(t + i, ti);
+
+        int ids;
+        memcpy(&ids, pathId + i, 4);
+        __m128i id = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(ids), _mm_setzero_si128()),
+                                        _mm_setzero_si128());
+        __m128 isAngular = _mm_castsi128_ps(_mm_cmpeq_epi32(id, _mm_set1_epi32(PATH_ANGULAR)));
+        __m128 isConvex = _mm_castsi128_ps(_mm_cmpeq_epi32(id, _mm_set1_epi32(PATH_CONVEX)));
+        __m128 isSinusoidal = _mm_castsi128_ps(_mm_cmpeq_epi32(id, _mm_set1_epi32(PATH_SINUSOIDAL)));
+        __m128 amp = _mm_or_ps(_mm_and_ps(isConvex, _mm_set1_ps(pathAmp[PATH_CONVEX])),
+                               _mm_and_ps(isSinusoidal, _mm_set1_ps(pathAmp[PATH_SINUSOIDAL])));
+        __m128 freq = _mm_or_ps(_mm_and_ps(isConvex, _mm_set1_ps(pathFreq[PATH_CONVEX])),
+                                _mm_and_ps(isSinusoidal, _mm_set1_ps(pathFreq[PATH_SINUSOIDAL])));
+        __m128 step = _mm_and_ps(isAngular, _mm_set1_ps(pathStep[PATH_ANGULAR]));
+        __m128 side = _mm_xor_ps(step, _mm_and_ps(_mm_cmplt_ps(ti, half), _mm_set1_ps(-0.0f)));
+
+        __m128 yi = _mm_add_ps(_mm_set1_ps(SCREEN_HEIGHT / 2.0f), _mm_mul_ps(amp, FastSin4(_mm_mul_ps(ti, freq))));
+        _mm_store_ps(x + i, _mm_mul_ps(ti, _mm_set1_ps((float)SCREEN_WIDTH)));
+        _mm_store_ps(y + i, _mm_add_ps(yi, side));
+
+        __m128 r = _mm_add_ps(_mm_load_ps(rotation + i), _mm_set1_ps(BALL_ROTATION_STEP));
+        _mm_store_ps(rotation + i, _mm_sub_ps(r, _mm_and_ps(_mm_cmpge_ps(r, full), full)));
+    }
+#endif
+    for (; i < end; i++) {
+        float ti = t[i] + velocity[i];
+        ti = ti > 1.0f ? 0.0f : ti;  // Reset to left edge
+        ti = ti < 0.0f ? 1.0f : ti;  // Reset to right edge
+        t[i] = ti;
+
+        x[i] = ti * SCREEN_WIDTH;
+        y[i] = PathY(pathId[i], ti);
+
+        float r = rotation[i] + BALL_ROTATION_STEP;
+        rotation[i] = r >= 360.0f ? r - 360.0f : r;
+    }
+
+    CircleHitsRacketBatch(x + begin, y + begin, BALL_RADIUS, racket, hits, end - begin);
+
+    // Balls moving right whose step ends past the racket's reach are swept
+    // against it instead (SweepCircleRacket), so fast balls cannot step over
+    // it and the hit lands where they first touched. A ball that wrapped
+    // from t = 1 to 0 is swept over its last step before the edge.
+    const float reach = (racket->x - BALL_RADIUS) / SCREEN_WIDTH;
+    for (int i = begin; i < end; i++) {
+        if (velocity[i] <= 0.0f) continue;
+        bool wrapped = t[i] == 0.0f;
+        float t1 = wrapped ? 1.0f : t[i];
+        hits[i - begin] = 0;
+        if (t1 < reach) continue;
+        float t0 = t1 - velocity[i];
+        float tHit = SweepCircleRacket(pathId[i], t0 > 0.0f ? t0 : 0.0f, t1, BALL_RADIUS, racket);
+        if (tHit >= 0.0f) {
+            t[i] = tHit;
+            y[i] = PathY(pathId[i], tHit);
+            hits[i - begin] = 1;
+        }
+    }
+
+    for (int i = begin; i < end; i++) {
+        if (hits[i - begin]) {
+            x[i] = racket->x - BALL_RADIUS;  // Adjust position to avoid overlap
+            velocity[i] = -(fabsf(velocity[i]) + BALL_VELOCITY_STEP);
+            paletteOffset[i] = (unsigned char)((paletteOffset[i] + 1) % BALL_MAX_COLORS);
+            racketHits++;
+        }
+        if (x[i] - BALL_RADIUS <= 0) {
+            velocity[i] = fabsf(velocity[i]);
+            paletteOffset[i] = (unsigned char)((paletteOffset[i] + BALL_MAX_COLORS - 1) % BALL_MAX_COLORS);
+        }
+    }
+    return racketHits;
+}
+
+static void UpdateRange(void *context, int begin, int end) {
+    BallStoreUpdateJob *job = context;
+    int hits = 0;
+    for (int block = begin; block < end; block += BALL_STORE_BLOCK) {
+        int blockEnd = block + BALL_STORE_BLOCK < end ? block + BALL_STORE_BLOCK : end;
+        hits += UpdateBlock(job->store, job->racket, block, blockEnd);
+    }
+    if (hits > 0) __atomic_add_fetch(&job->racketHits, hits, __ATOMIC_RELAXED);
+}
+
+int BallStoreUpdate(BallStore *store, JobSystem *jobs, const Racket *racket) {
+    TRACE_ZONE("crowd update");
+    BallStoreUpdateJob job = {store, racket, 0};
+    JobSystemParallelFor(jobs, store->count, BALL_STORE_GRAIN, UpdateRange, &job);
+    return job.racketHits;
+}
+
+typedef struct {
+    BallStore *store;
+    const Racket *rackets;
+} CollideContext;
+
+static void BounceBalls(void *context, int a, int b) {
+    BallStore *store = ((CollideContext *)context)->store;
+    float *velocity = store->velocity;
+    float gap = store->x[b] - store->x[a];
+    if (gap * (velocity[b] - velocity[a]) < 0.0f) {
+        float swap = velocity[a];
+        velocity[a] = velocity[b];
+        velocity[b] = swap;
+    }
+}
+
+static void BounceOffRacket(void *context, int ball, int index) {
+    CollideContext *collide = context;
+    BallStore *store = collide->store;
+    const Racket *racket = &collide->rackets[index];
+    float speed = fabsf(store->velocity[ball]) + BALL_VELOCITY_STEP;
+
+    if (store->x[ball] < racket->x + racket->width / 2) {
+        store->x[ball] = racket->x - BALL_RADIUS;
+        store->velocity[ball] = -speed;
+    } else {
+        store->x[ball] = racket->x + racket->width + BALL_RADIUS;
+        store->velocity[ball] = speed;
+    }
+    store->paletteOffset[ball] = (unsigned char)((store->paletteOffset[ball] + 1) % BALL_MAX_COLORS);
+}
+
+int BallStoreCollide(BallStore *store, SpatialHash *hash, JobSystem *jobs, const Racket *rackets, int racketCount,
+                     int *racketHits) {
+    TRACE_ZONE("crowd collide");
+    CollideContext context = {store, rackets};
+    if (!SpatialHashBuild(hash, store->x, store->y, store->count)) {
+        if (racketHits != NULL) *racketHits = 0;
+        return 0;
+    }
+
+    int pairs = SpatialHashForEachPairParallel(hash, jobs, BALL_RADIUS, BounceBalls, &context);
+    int contacts = SpatialHashForEachRacketContact(hash, BALL_RADIUS, rackets, racketCount, BounceOffRacket, &context);
+    if (racketHits != NULL) *racketHits = contacts;
+    return pairs;
+}
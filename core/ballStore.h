@@ -0,0 +1,99 @@
+#ifndef BALL_STORE_H
+#define BALL_STORE_H
+
+#include <stdbool.h>
+#include "ball.h"
+#include "jobSystem.h"
+#include "spatialHash.h"
+
+// Structure-of-arrays ball container for large crowds.
+//
+// Each field lives in its own 64-byte aligned array, indexed by a dense
+// index in [0, count), so an update pass streams only the arrays it reads
+// (t, velocity and pathId in; x, y, rotation out) instead of whole Ball
+// records. Compared to Ball:
+//   - direction is the sign of velocity (negative = moving left)
+//   - the six stripe colours are one palette offset: stripe i uses palette
+//     index (paletteOffset + i) % BALL_MAX_COLORS, so rotating the colours
+//     is an increment
+//   - rotation is kept in [0, 360)
+//
+// Despawning moves the last ball into the hole, so dense indices change.
+// BallHandle stays valid for the life of the ball and goes stale (rather
+// than pointing at a different ball) once it is despawned.
+
+typedef struct {
+    unsigned int slot;        // Entry in the handle table
+    unsigned int generation;  // Bumped each time the slot is reused
+} BallHandle;
+
+typedef struct {
+    int count;                   // Live balls
+    int capacity;                // Allocated entries per array
+    float *x;
+    float *y;
+    float *t;
+    float *velocity;             // Step in t per update, sign = direction
+    float *rotation;             // Degrees, [0, 360)
+    unsigned char *pathId;       // PATH_* id
+    unsigned char *paletteOffset;
+
+    // Handle table: slot -> dense index and back, plus a free list of slots
+    unsigned int *denseToSlot;
+    int *slotToDense;            // -1 for free slots
+    unsigned int *generations;
+    int *freeSlots;
+    int freeCount;
+    int slotCount;
+} BallStore;
+
+bool BallStoreInit(BallStore *store, int capacity);
+void BallStoreFree(BallStore *store);
+
+// Grow every array to hold at least `capacity` balls; handles stay valid
+bool BallStoreReserve(BallStore *store, int capacity);
+
+// Append `count` balls on `path` in their InitBall state (direction right)
+// and return the dense index of the first, or -1 when out of memory. The new
+// balls occupy [first, first + count), so callers can fill the arrays
+// directly. Handles are written to `handles` unless it is NULL.
+int BallStoreSpawn(BallStore *store, int count, int path, BallHandle *handles);
+
+// Spread balls [first, first + count) along t like InitBallCrowd
+void BallStoreSpreadCrowd(BallStore *store, int first, int count);
+
+// Grow the store to `count` balls, spawned evenly over all paths and spread
+// with BallStoreSpreadCrowd, or shrink it by despawning the balls at the end.
+// Returns false when out of memory.
+bool BallStoreResizeCrowd(BallStore *store, int count);
+
+// Remove the balls behind `handles`, skipping stale ones. Returns the number
+// removed.
+int BallStoreDespawn(BallStore *store, const BallHandle *handles, int count);
+
+// Dense index of a live handle, -1 when it is stale
+int BallStoreIndex(const BallStore *store, BallHandle handle);
+
+// Handle of the ball at a dense index
+BallHandle BallStoreHandle(const BallStore *store, int index);
+
+// UpdateBall for every ball: step t, evaluate the path, spin, and bounce off
+// the racket and the left wall. Runs in chunks on the job system. Returns
+// the number of racket hits.
+int BallStoreUpdate(BallStore *store, JobSystem *jobs, const Racket *racket);
+
+// Ball-ball and ball-racket collisions through a spatial hash rebuilt from
+// the current positions (cell size 2 * BALL_RADIUS works best):
+//   - two overlapping balls closing in on each other in x swap velocities,
+//     an elastic bounce between equal masses along their paths
+//   - a ball touching a racket is sent away from the racket's centre line,
+//     sped up and has its colours rotated, like the racket in UpdateBall
+// Linear in balls plus contacts. The pair tests run on `jobs` (NULL: on the
+// calling thread) and the bounces are applied afterwards in a fixed order,
+// so the result does not depend on the number of workers. Returns the
+// number of ball pairs; *racketHits (if not NULL) gets the number of racket
+// contacts.
+int BallStoreCollide(BallStore *store, SpatialHash *hash, JobSystem *jobs, const Racket *rackets, int racketCount,
+                     int *racketHits);
+
+#endif // BALL_STORE_H
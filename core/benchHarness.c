@@ -0,0 +1,252 @@
+#include "benchHarness.h"
+#include <stdlib.h>
+#include <string.h>
+#include "timing.h"
+
+#define BENCH_MAX_TRIALS 1001
+
+// Shared by every run; opened on the first one that asks for counters
+static PerfCounters benchCounters;
+static int benchCountersState;  // 0 not tried yet, 1 open, -1 unavailable
+
+void BenchConfigDefaults(BenchConfig *config) {
+    config->warmupSeconds = 0.05;
+    config->trialSeconds = 0.02;
+    config->trials = 31;
+    config->format = BENCH_FORMAT_TEXT;
+    config->counters = false;
+    config->label = "";
+    config->out = stdout;
+    config->reported = 0;
+}
+
+bool BenchParseArgs(BenchConfig *config, int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            config->format = BENCH_FORMAT_CSV;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            config->format = BENCH_FORMAT_JSON;
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            config->warmupSeconds = 0.01;
+            config->trialSeconds = 0.002;
+            config->trials = 11;
+        } else if (strcmp(argv[i], "--counters") == 0) {
+            config->counters = true;
+        } else if (strcmp(argv[i], "--trials") == 0 && i + 1 < argc) {
+            config->trials = atoi(argv[++i]);
+            if (config->trials < 1 || config->trials > BENCH_MAX_TRIALS) return false;
+        } else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc) {
+            config->label = argv[++i];
+        }
+    }
+    return true;
+}
+
+double BenchNow(void) {
+    return GetHighPrecisionTime();
+}
+
+// Open the counters the first time they are asked for; without any, drop
+// --counters with a note on stderr
+static bool BenchCountersReady(BenchConfig *config) {
+    if (!config->counters) return false;
+    if (benchCountersState == 0) {
+        benchCountersState = PerfCountersOpen(&benchCounters) ? 1 : -1;
+        if (benchCountersState < 0) {
+            fprintf(stderr, "hardware counters unavailable, reporting times only: %s\n", benchCounters.error);
+        } else if (benchCounters.opened < PERF_COUNTER_COUNT) {
+            fprintf(stderr, "some hardware counters unavailable: %s\n", benchCounters.error);
+        }
+    }
+    if (benchCountersState < 0) config->counters = false;
+    return config->counters;
+}
+
+// Instructions per cycle, negative when either was not counted
+static double Ipc(const BenchResult *result) {
+    double cycles = result->counters[PERF_COUNTER_CYCLES];
+    double instructions = result->counters[PERF_COUNTER_INSTRUCTIONS];
+    return cycles > 0.0 && instructions >= 0.0 ? instructions / cycles : -1.0;
+}
+
+// Per-sample counts after the times: text columns, CSV fields (empty when not
+// counted) or JSON members (null)
+static void ReportCounters(const BenchConfig *config, const BenchResult *result) {
+    static const char *columns[PERF_COUNTER_COUNT] = {"cycles", "instr", "br-miss", "l1d-miss", "llc-miss"};
+    static const char *keys[PERF_COUNTER_COUNT] = {"cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses"};
+    double ipc = Ipc(result);
+    FILE *out = config->out;
+
+    for (int i = 0; i <= PERF_COUNTER_COUNT; i++) {
+        // IPC goes after the instructions
+        bool isIpc = i == PERF_COUNTER_INSTRUCTIONS + 1;
+        int counter = i > PERF_COUNTER_INSTRUCTIONS + 1 ? i - 1 : i;
+        double value = isIpc ? ipc : result->counters[counter];
+        const char *name = isIpc ? "ipc" : config->format == BENCH_FORMAT_TEXT ? columns[counter] : keys[counter];
+
+        switch (config->format) {
+            case BENCH_FORMAT_CSV:
+                if (value >= 0.0) fprintf(out, ",%.4f", value);
+                else fprintf(out, ",");
+                break;
+            case BENCH_FORMAT_JSON:
+                if (value >= 0.0) fprintf(out, ", \"%s\": %.4f", name, value);
+                else fprintf(out, ", \"%s\": null", name);
+                break;
+            default:
+                if (value >= 0.0) fprintf(out, "  %s %.3f", name, value);
+                else fprintf(out, "  %s -", name);
+                break;
+        }
+    }
+}
+
+static int CompareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Labels are free-form, so quotes, backslashes and control characters are
+// escaped
+static void WriteJsonString(FILE *out, const char *text) {
+    fputc('"', out);
+    for (; *text != '\0'; text++) {
+        unsigned char c = (unsigned char)*text;
+        if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+        else if (c < 0x20) fprintf(out, "\\u%04x", c);
+        else fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+// CSV field per RFC 4180: quoted, with embedded quotes doubled, when it holds
+// a comma, quote or line break
+static void WriteCsvField(FILE *out, const char *text) {
+    if (strpbrk(text, ",\"\r\n") == NULL) {
+        fputs(text, out);
+        return;
+    }
+    fputc('"', out);
+    for (; *text != '\0'; text++) {
+        if (*text == '"') fputc('"', out);
+        fputc(*text, out);
+    }
+    fputc('"', out);
+}
+
+static void ReportResult(BenchConfig *config, const BenchResult *result) {
+    FILE *out = config->out;
+    if (out == NULL) return;
+
+    switch (config->format) {
+        case BENCH_FORMAT_CSV:
+            WriteCsvField(out, config->label);
+            fputc(',', out);
+            WriteCsvField(out, result->name);
+            fputc(',', out);
+            WriteCsvField(out, result->variant);
+            fprintf(out, ",%lld,%lld,%d,%.4f,%.4f,%.4f,%.4f", result->samples,
+                    result->iterations, result->trials, result->minNs, result->medianNs,
+                    result->p99Ns, result->meanNs);
+            if (config->counters) ReportCounters(config, result);
+            fprintf(out, "\n");
+            break;
+        case BENCH_FORMAT_JSON:
+            fprintf(out, "%s\n  {\"label\": ", config->reported > 0 ? "," : "");
+            WriteJsonString(out, config->label);
+            fprintf(out, ", \"name\": ");
+            WriteJsonString(out, result->name);
+            fprintf(out, ", \"variant\": ");
+            WriteJsonString(out, result->variant);
+            fprintf(out, ", \"samples\": %lld, \"iterations\": %lld, \"trials\": %d, "
+                    "\"min_ns\": %.4f, \"median_ns\": %.4f, \"p99_ns\": %.4f, \"mean_ns\": %.4f",
+                    result->samples, result->iterations, result->trials, result->minNs,
+                    result->medianNs, result->p99Ns, result->meanNs);
+            if (config->counters) ReportCounters(config, result);
+            fprintf(out, "}");
+            break;
+        default:
+            fprintf(out, "%-12s %-10s min %8.3f  median %8.3f  p99 %8.3f ns/sample",
+                    result->name, result->variant, result->minNs, result->medianNs, result->p99Ns);
+            if (config->counters) ReportCounters(config, result);
+            fprintf(out, "\n");
+            break;
+    }
+    config->reported++;
+}
+
+void BenchReportBegin(BenchConfig *config) {
+    config->reported = 0;
+    BenchCountersReady(config);
+    if (config->out == NULL) return;
+    if (config->format == BENCH_FORMAT_CSV) {
+        fprintf(config->out, "label,name,variant,samples,iterations,trials,min_ns,median_ns,p99_ns,mean_ns%s\n",
+                config->counters ? ",cycles,instructions,ipc,branch_misses,l1d_misses,llc_misses" : "");
+    } else if (config->format == BENCH_FORMAT_JSON) {
+        fprintf(config->out, "[");
+    }
+}
+
+void BenchReportEnd(BenchConfig *config) {
+    if (config->out == NULL) return;
+    if (config->format == BENCH_FORMAT_JSON) {
+        fprintf(config->out, "\n]\n");
+    }
+    fflush(config->out);
+}
+
+BenchResult BenchRun(BenchConfig *config, const char *name, const char *variant,
+                     BenchFunction function, void *context, long long samples) {
+    static double trialNs[BENCH_MAX_TRIALS];
+    BenchResult result = {name, variant, samples, 1, config->trials, 0.0, 0.0, 0.0, 0.0, {0.0}};
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) result.counters[i] = -1.0;
+    bool counting = BenchCountersReady(config);
+
+    // Warm caches, branch predictors and clocks, doubling the pass count until
+    // one run is long enough to time reliably
+    long long iterations = 1;
+    double elapsed = 0.0, warmupStart = BenchNow();
+    for (;;) {
+        double start = BenchNow();
+        function(context, iterations);
+        elapsed = BenchNow() - start;
+        if (BenchNow() - warmupStart >= config->warmupSeconds && elapsed >= config->trialSeconds / 8) break;
+        if (elapsed < config->trialSeconds / 2) iterations *= 2;
+    }
+
+    // Calibrate the pass count to the target trial length
+    double perIteration = elapsed / (double)iterations;
+    result.iterations = (long long)(config->trialSeconds / perIteration);
+    if (result.iterations < 1) result.iterations = 1;
+
+    // The counters run across all trials, clock reads included; those are a
+    // few hundred cycles against a trial of milliseconds
+    double total = 0.0;
+    if (counting) PerfCountersStart(&benchCounters);
+    for (int trial = 0; trial < config->trials; trial++) {
+        double start = BenchNow();
+        function(context, result.iterations);
+        double seconds = BenchNow() - start;
+        trialNs[trial] = seconds * 1e9 / ((double)result.iterations * (double)samples);
+        total += trialNs[trial];
+    }
+    if (counting) {
+        PerfCountersStop(&benchCounters);
+        PerfSample sample;
+        PerfCountersRead(&benchCounters, &sample);
+        double perSample = 1.0 / ((double)config->trials * (double)result.iterations * (double)samples);
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            if (sample.values[i] >= 0.0) result.counters[i] = sample.values[i] * perSample;
+        }
+    }
+
+    qsort(trialNs, config->trials, sizeof(double), CompareDoubles);
+    int p99Index = (99 * config->trials + 99) / 100 - 1;
+    result.minNs = trialNs[0];
+    result.medianNs = trialNs[config->trials / 2];
+    result.p99Ns = trialNs[p99Index];
+    result.meanNs = total / config->trials;
+
+    ReportResult(config, &result);
+    return result;
+}
@@ -0,0 +1,90 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "perfCounters.h"
+
+// Micro-benchmark harness.
+//
+// A benchmark is a function that runs `iterations` passes of some kernel over
+// a fixed number of samples. The harness warms it up, calibrates the number
+// of passes so one trial lasts about `trialSeconds`, runs `trials` trials and
+// reports min / median / p99 time per sample in nanoseconds.
+//
+// With --counters the timed trials also run under the hardware performance
+// counters (perfCounters.h), reported per sample next to the times: cycles,
+// instructions, IPC, branch misses and L1D / LLC misses. When the counters
+// cannot be opened the run says why on stderr and reports times only.
+//
+// Benchmarks must feed every result they compute into BenchDoNotOptimize (or
+// store it somewhere BenchEscape has exposed); otherwise the compiler is free
+// to delete pure C kernels while keeping `volatile` asm ones, and the numbers
+// compare nothing with something.
+
+#define BENCH_FORMAT_TEXT 0
+#define BENCH_FORMAT_CSV 1
+#define BENCH_FORMAT_JSON 2
+
+typedef void (*BenchFunction)(void *context, long long iterations);
+
+typedef struct {
+    double warmupSeconds;  // Time spent running the kernel before calibrating
+    double trialSeconds;   // Target duration of one trial
+    int trials;            // Number of timed trials
+    int format;            // BENCH_FORMAT_*
+    bool counters;         // Count hardware events during the trials
+    const char *label;     // Free-form tag (e.g. a commit id) copied into every row
+    FILE *out;             // Report destination, NULL for no report
+    int reported;          // Rows written so far (JSON separators)
+} BenchConfig;
+
+typedef struct {
+    const char *name;      // What is measured, e.g. "convex"
+    const char *variant;   // Which implementation, e.g. "c", "asm", "avx2"
+    long long samples;     // Samples processed per iteration
+    long long iterations;  // Iterations per trial after calibration
+    int trials;
+    double minNs;          // Nanoseconds per sample
+    double medianNs;
+    double p99Ns;
+    double meanNs;
+    double counters[PERF_COUNTER_COUNT];  // Events per sample, negative when not counted
+} BenchResult;
+
+// Keep a value alive without generating any code for it
+static inline void BenchDoNotOptimize(float value) {
+#if defined(__x86_64__) || defined(__i386__)
+    __asm__ volatile("" : "+x"(value));
+#else
+    __asm__ volatile("" : "+r"(value));
+#endif
+}
+
+// Make the compiler assume *pointer is read and written by someone else
+static inline void BenchEscape(void *pointer) {
+    __asm__ volatile("" : : "g"(pointer) : "memory");
+}
+
+// Make the compiler assume all memory is read and written by someone else
+static inline void BenchClobberMemory(void) {
+    __asm__ volatile("" : : : "memory");
+}
+
+void BenchConfigDefaults(BenchConfig *config);
+
+// Parse --csv, --json, --quick, --counters, --trials N, --label TEXT.
+// Unknown arguments are left alone; returns false on a malformed value.
+bool BenchParseArgs(BenchConfig *config, int argc, char **argv);
+
+// Monotonic wall clock in seconds
+double BenchNow(void);
+
+BenchResult BenchRun(BenchConfig *config, const char *name, const char *variant,
+                     BenchFunction function, void *context, long long samples);
+
+// Report framing (header / closing bracket); BenchRun reports each row itself
+void BenchReportBegin(BenchConfig *config);
+void BenchReportEnd(BenchConfig *config);
+
+#endif // BENCH_HARNESS_H
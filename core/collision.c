@@ -0,0 +1,143 @@
+#include "collision.h"
+#include <string.h>
+#include "cpuDispatch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define COLLISION_X86 1
+#endif
+
+bool CircleHitsRacket(Vector2 center, float radius, const Racket *racket) {
+    return center.x + radius >= racket->x &&
+           center.y >= racket->y &&
+           center.y <= racket->y + racket->height;
+}
+
+float SweepCircleRacket(int path, float t0, float t1, float radius, const Racket *racket) {
+    // x = t * SCREEN_WIDTH on every path, so the front edge condition is
+    // t >= reach; after that only y has to come into the racket's span
+    double reach = ((double)racket->x - radius) / SCREEN_WIDTH;
+    double start = t0 > reach ? t0 : reach;
+    if (start > t1) return -1.0f;
+    double t = PathFirstTimeInBand(path, start, t1, racket->y, (double)racket->y + racket->height);
+    return (float)t;
+}
+
+bool CircleHitsLeftWall(Vector2 center, float radius) {
+    return center.x - radius <= 0;
+}
+
+bool CircleIntersectsCircle(Vector2 a, float radiusA, Vector2 b, float radiusB) {
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float reach = radiusA + radiusB;
+    return dx * dx + dy * dy <= reach * reach;
+}
+
+bool CircleIntersectsRect(Vector2 center, float radius, const Racket *rect) {
+    // Distance from the centre to the closest point of the rectangle
+    float nearestX = center.x < rect->x ? rect->x : (center.x > rect->x + rect->width ? rect->x + rect->width : center.x);
+    float nearestY = center.y < rect->y ? rect->y : (center.y > rect->y + rect->height ? rect->y + rect->height : center.y);
+    float dx = center.x - nearestX;
+    float dy = center.y - nearestY;
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+void CircleHitsRacketBatch(const float *x, const float *y, float radius,
+                           const Racket *racket, unsigned char *hits, int count) {
+    GetCpuDispatch()->circleHitsRacketBatch(x, y, radius, racket, hits, count);
+}
+
+void CircleHitsRacketBatchScalar(const float *x, const float *y, float radius,
+                                 const Racket *racket, unsigned char *hits, int count) {
+    for (int i = 0; i < count; i++) {
+        hits[i] = CircleHitsRacket((Vector2){x[i], y[i]}, radius, racket);
+    }
+}
+
+#ifdef COLLISION_X86
+
+// The vector kernels compare against the same three bounds as
+// CircleHitsRacket (x + radius >= left becomes x >= left - radius) and narrow
+// the all-ones lane masks to 0/1 bytes with saturating packs
+
+__attribute__((target("sse2")))
+void CircleHitsRacketBatchSSE(const float *x, const float *y, float radius,
+                              const Racket *racket, unsigned char *hits, int count) {
+    const __m128 left = _mm_set1_ps(racket->x - radius);
+    const __m128 top = _mm_set1_ps(racket->y);
+    const __m128 bottom = _mm_set1_ps(racket->y + racket->height);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 xv = _mm_loadu_ps(x + i);
+        __m128 yv = _mm_loadu_ps(y + i);
+        __m128 hit = _mm_and_ps(_mm_cmpge_ps(xv, left),
+                                _mm_and_ps(_mm_cmpge_ps(yv, top), _mm_cmple_ps(yv, bottom)));
+        __m128i lanes = _mm_and_si128(_mm_castps_si128(hit), _mm_set1_epi32(1));
+        __m128i bytes = _mm_packs_epi16(_mm_packs_epi32(lanes, lanes), lanes);
+        int packed = _mm_cvtsi128_si32(bytes);
+        memcpy(hits + i, &packed, 4);
+    }
+    CircleHitsRacketBatchScalar(x + i, y + i, radius, racket, hits + i, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+void CircleHitsRacketBatchAVX2(const float *x, const float *y, float radius,
+                               const Racket *racket, unsigned char *hits, int count) {
+    const __m256 left = _mm256_set1_ps(racket->x - radius);
+    const __m256 top = _mm256_set1_ps(racket->y);
+    const __m256 bottom = _mm256_set1_ps(racket->y + racket->height);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 xv = _mm256_loadu_ps(x + i);
+        __m256 yv = _mm256_loadu_ps(y + i);
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(xv, left, _CMP_GE_OQ),
+                                   _mm256_and_ps(_mm256_cmp_ps(yv, top, _CMP_GE_OQ),
+                                                 _mm256_cmp_ps(yv, bottom, _CMP_LE_OQ)));
+        __m256i lanes = _mm256_and_si256(_mm256_castps_si256(hit), _mm256_set1_epi32(1));
+        __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+        _mm_storel_epi64((__m128i *)(hits + i), _mm_packs_epi16(words, words));
+    }
+    CircleHitsRacketBatchScalar(x + i, y + i, radius, racket, hits + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void CircleHitsRacketBatchAVX512(const float *x, const float *y, float radius,
+                                 const Racket *racket, unsigned char *hits, int count) {
+    const __m512 left = _mm512_set1_ps(racket->x - radius);
+    const __m512 top = _mm512_set1_ps(racket->y);
+    const __m512 bottom = _mm512_set1_ps(racket->y + racket->height);
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m512 xv = _mm512_loadu_ps(x + i);
+        __m512 yv = _mm512_loadu_ps(y + i);
+        __mmask16 mask = _mm512_cmp_ps_mask(xv, left, _CMP_GE_OQ);
+        mask = _mm512_mask_cmp_ps_mask(mask, yv, top, _CMP_GE_OQ);
+        mask = _mm512_mask_cmp_ps_mask(mask, yv, bottom, _CMP_LE_OQ);
+        __m512i lanes = _mm512_maskz_mov_epi32(mask, _mm512_set1_epi32(1));
+        _mm_storeu_si128((__m128i *)(hits + i), _mm512_cvtepi32_epi8(lanes));
+    }
+    CircleHitsRacketBatchScalar(x + i, y + i, radius, racket, hits + i, count - i);
+}
+
+#else // !COLLISION_X86
+
+void CircleHitsRacketBatchSSE(const float *x, const float *y, float radius,
+                              const Racket *racket, unsigned char *hits, int count) {
+    CircleHitsRacketBatchScalar(x, y, radius, racket, hits, count);
+}
+
+void CircleHitsRacketBatchAVX2(const float *x, const float *y, float radius,
+                               const Racket *racket, unsigned char *hits, int count) {
+    CircleHitsRacketBatchScalar(x, y, radius, racket, hits, count);
+}
+
+void CircleHitsRacketBatchAVX512(const float *x, const float *y, float radius,
+                                 const Racket *racket, unsigned char *hits, int count) {
+    CircleHitsRacketBatchScalar(x, y, radius, racket, hits, count);
+}
+
+#endif // COLLISION_X86
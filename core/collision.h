@@ -0,0 +1,46 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <stdbool.h>
+#include "paths.h"
+
+// Racket (player paddle), position is the top-left corner
+typedef struct {
+    float x, y;
+    float width, height;
+} Racket;
+
+// Ball front edge reaches the racket while the centre is level with it
+bool CircleHitsRacket(Vector2 center, float radius, const Racket *racket);
+
+// Swept CircleHitsRacket for a ball moving right along path `path` (a PATH_*
+// id) from t0 to t1: the first t in [t0, t1] at which the front edge has
+// reached the racket while the centre is level with it, or -1 when there is
+// none. Solved analytically, so a fast ball cannot step over the racket
+// between two updates.
+float SweepCircleRacket(int path, float t0, float t1, float radius, const Racket *racket);
+
+// Ball back edge reaches the left wall (x = 0)
+bool CircleHitsLeftWall(Vector2 center, float radius);
+
+// Exact overlap tests (touching counts) for the broadphase in spatialHash.h
+bool CircleIntersectsCircle(Vector2 a, float radiusA, Vector2 b, float radiusB);
+bool CircleIntersectsRect(Vector2 center, float radius, const Racket *rect);
+
+// CircleHitsRacket for `count` balls stored as separate x and y arrays;
+// hits[i] is set to 1 or 0. Goes through the kernel bound in cpuDispatch.h.
+void CircleHitsRacketBatch(const float *x, const float *y, float radius,
+                           const Racket *racket, unsigned char *hits, int count);
+
+// Width-specific kernels: scalar, 4-wide SSE2, 8-wide AVX2, 16-wide AVX-512.
+// The caller must make sure the CPU supports the instruction set it picks.
+void CircleHitsRacketBatchScalar(const float *x, const float *y, float radius,
+                                 const Racket *racket, unsigned char *hits, int count);
+void CircleHitsRacketBatchSSE(const float *x, const float *y, float radius,
+                              const Racket *racket, unsigned char *hits, int count);
+void CircleHitsRacketBatchAVX2(const float *x, const float *y, float radius,
+                               const Racket *racket, unsigned char *hits, int count);
+void CircleHitsRacketBatchAVX512(const float *x, const float *y, float radius,
+                                 const Racket *racket, unsigned char *hits, int count);
+
+#endif // COLLISION_H
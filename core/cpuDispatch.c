@@ -0,0 +1,111 @@
+#include "cpuDispatch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pathBatch.h"
+#include "pathFixed.h"
+#include "pathSpec.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <cpuid.h>
+#define CPU_DISPATCH_X86 1
+#endif
+
+const char *cpuTierNames[CPU_TIER_COUNT] = {"scalar", "sse2", "avx2", "avx512"};
+
+static const CpuDispatch dispatchTables[CPU_TIER_COUNT] = {
+    {CPU_TIER_SCALAR, CalculatePathBatchScalar, PathSpecBatchScalar, PathFixedBatchScalar, CircleHitsRacketBatchScalar, SoftRasterSpanScalar},
+    {CPU_TIER_SSE2, CalculatePathBatchSSE, PathSpecBatchSSE, PathFixedBatchSSE, CircleHitsRacketBatchSSE, SoftRasterSpanSSE},
+    {CPU_TIER_AVX2, CalculatePathBatchAVX2, PathSpecBatchAVX2, PathFixedBatchAVX2, CircleHitsRacketBatchAVX2, SoftRasterSpanAVX2},
+    {CPU_TIER_AVX512, CalculatePathBatchAVX512, PathSpecBatchAVX512, PathFixedBatchAVX512, CircleHitsRacketBatchAVX512, SoftRasterSpanAVX2},
+};
+
+#ifdef CPU_DISPATCH_X86
+
+// XCR0: which register states the OS saves on a context switch
+static unsigned long long ReadXcr0(void) {
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+}
+
+static int ProbeCpuTier(void) {
+    unsigned int eax, ebx, ecx, edx;
+    unsigned long long xcr0;
+    int tier = CPU_TIER_SCALAR;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return tier;
+    if (edx & bit_SSE2) tier = CPU_TIER_SSE2;
+
+    // AVX state needs OSXSAVE plus the XMM and YMM bits in XCR0
+    if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX) || !(ecx & bit_FMA)) return tier;
+    xcr0 = ReadXcr0();
+    if ((xcr0 & 0x6) != 0x6) return tier;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return tier;
+    if (!(ebx & bit_AVX2)) return tier;
+    tier = CPU_TIER_AVX2;
+
+    // AVX-512 additionally needs the opmask and both ZMM halves (bits 5-7)
+    if ((ebx & bit_AVX512F) && (xcr0 & 0xe6) == 0xe6) tier = CPU_TIER_AVX512;
+    return tier;
+}
+
+#else // !CPU_DISPATCH_X86
+
+static int ProbeCpuTier(void) {
+    return CPU_TIER_SCALAR;
+}
+
+#endif // CPU_DISPATCH_X86
+
+int DetectCpuTier(void) {
+    static int detected = -1;
+    int tier = __atomic_load_n(&detected, __ATOMIC_RELAXED);
+    if (tier < 0) {
+        tier = ProbeCpuTier();
+        __atomic_store_n(&detected, tier, __ATOMIC_RELAXED);
+    }
+    return tier;
+}
+
+int ParseCpuTier(const char *name) {
+    for (int tier = 0; tier < CPU_TIER_COUNT; tier++) {
+        if (strcmp(name, cpuTierNames[tier]) == 0) return tier;
+    }
+    return -1;
+}
+
+const CpuDispatch *GetCpuDispatchForTier(int tier) {
+    int supported = DetectCpuTier();
+    if (tier < 0) tier = CPU_TIER_SCALAR;
+    if (tier > supported) tier = supported;
+    return &dispatchTables[tier];
+}
+
+const CpuDispatch *GetCpuDispatch(void) {
+    static const CpuDispatch *bound = NULL;
+    const CpuDispatch *dispatch = __atomic_load_n(&bound, __ATOMIC_ACQUIRE);
+    if (dispatch != NULL) return dispatch;
+
+    // Every thread that gets here computes the same answer, so a race only
+    // costs a repeated probe (and at worst a repeated warning)
+    int tier = DetectCpuTier();
+    const char *forced = getenv("BALLCORE_TIER");
+    if (forced != NULL && forced[0] != '\0') {
+        int requested = ParseCpuTier(forced);
+        if (requested < 0) {
+            fprintf(stderr, "BALLCORE_TIER=%s is not one of scalar, sse2, avx2, avx512; using %s\n",
+                    forced, cpuTierNames[tier]);
+        } else if (requested > tier) {
+            fprintf(stderr, "BALLCORE_TIER=%s is not supported by this CPU; using %s\n",
+                    forced, cpuTierNames[tier]);
+        } else {
+            tier = requested;
+        }
+    }
+
+    dispatch = &dispatchTables[tier];
+    __atomic_store_n(&bound, dispatch, __ATOMIC_RELEASE);
+    return dispatch;
+}
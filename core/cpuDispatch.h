@@ -0,0 +1,58 @@
+#ifndef CPU_DISPATCH_H
+#define CPU_DISPATCH_H
+
+#include "collision.h"
+#include "pathFixed.h"
+#include "paths.h"
+#include "softRaster.h"
+
+// Runtime selection of the vector kernels.
+//
+// The CPU is probed with CPUID (and XGETBV, so a tier is only picked when the
+// OS also saves its registers) the first time GetCpuDispatch is called, and
+// the batch entry points go through the function pointers bound there. One
+// binary therefore uses AVX-512 on machines that have it and SSE2 on ones
+// that do not, without -march flags.
+//
+// Setting BALLCORE_TIER to scalar, sse2, avx2 or avx512 forces a lower tier
+// (for comparisons or to rule a kernel out). A tier the CPU does not support
+// is clamped to the best one it does, with a warning on stderr.
+
+#define CPU_TIER_SCALAR 0
+#define CPU_TIER_SSE2 1
+#define CPU_TIER_AVX2 2    // AVX2 + FMA
+#define CPU_TIER_AVX512 3  // AVX-512F
+#define CPU_TIER_COUNT 4
+
+typedef void (*PathBatchFunction)(int path, const float *t, float *x, float *y, int count);
+typedef void (*PathFixedBatchFunction)(int path, const Fixed *t, Fixed *x, Fixed *y, int count);
+typedef void (*RacketHitBatchFunction)(const float *x, const float *y, float radius,
+                                       const Racket *racket, unsigned char *hits, int count);
+typedef void (*RasterSpanFunction)(unsigned int *pixels, int count, float dx, float dy, const RasterBall *ball);
+
+typedef struct {
+    int tier;                                     // CPU_TIER_* the kernels below belong to
+    PathBatchFunction pathBatch;                  // CalculatePathBatch*
+    PathBatchFunction pathSpecBatch;              // PathSpecBatch* (ids are PATH_SPEC_*)
+    PathFixedBatchFunction pathFixedBatch;        // PathFixedBatch* (Q16.16, same bits on every tier)
+    RacketHitBatchFunction circleHitsRacketBatch; // CircleHitsRacketBatch*
+    RasterSpanFunction rasterSpan;                // SoftRasterSpan* (AVX-512 uses AVX2)
+} CpuDispatch;
+
+// Lower-case tier names, the values BALLCORE_TIER accepts
+extern const char *cpuTierNames[CPU_TIER_COUNT];
+
+// Highest tier this CPU and OS support, ignoring BALLCORE_TIER
+int DetectCpuTier(void);
+
+// CPU_TIER_* for a name in cpuTierNames, -1 if there is none
+int ParseCpuTier(const char *name);
+
+// Kernels of the detected tier, or of BALLCORE_TIER when it is set. Bound on
+// the first call; safe to call from any thread.
+const CpuDispatch *GetCpuDispatch(void);
+
+// Kernels of a given tier, clamped to what the CPU supports
+const CpuDispatch *GetCpuDispatchForTier(int tier);
+
+#endif // CPU_DISPATCH_H
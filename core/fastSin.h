@@ -0,0 +1,150 @@
+#ifndef FAST_SIN_H
+#define FAST_SIN_H
+
+// Single-precision sine without a libm call.
+//
+// Contract (all variants): for |x| <= FAST_SIN_RANGE the result differs from
+// the correctly rounded sin(x) by at most 3 ulp, and by at most 1.5e-7 in
+// absolute terms. Once round(x / pi) passes FAST_SIN_K_MAX (just beyond
+// FAST_SIN_RANGE), and for NaN and infinity, the result is NaN.
+//
+// Method: k = round(x / pi), r = x - k*pi with pi split into four parts
+// (Cody-Waite, exact products up to the range limit), sin(x) = (-1)^k sin(r)
+// for r in [-pi/2, pi/2], and sin(r) from a degree-9 odd minimax polynomial.
+// The range check looks at k, so the vector variants need no extra register
+// for x: out-of-range and NaN inputs convert to a huge k (or the integer
+// indefinite value) and fail it.
+//
+// The SIMD variants are compiled with target attributes, so this header can
+// be included from any translation unit; the caller is responsible for only
+// calling a variant the CPU supports.
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FAST_SIN_X86 1
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#define FAST_SIN_RANGE 8192.0f
+#define FAST_SIN_K_MAX 2608.0f  // round(FAST_SIN_RANGE / pi)
+
+#define FAST_SIN_INV_PI 0.318309886183790671538f
+#define FAST_SIN_PI_A 3.140625f
+#define FAST_SIN_PI_B 0.0009670257568359375f
+#define FAST_SIN_PI_C 6.2771141529083251953e-07f
+#define FAST_SIN_PI_D 1.2154201256553420762e-10f
+
+#define FAST_SIN_C1 -0.166666597127914428710938f
+#define FAST_SIN_C2 0.00833307858556509017944336f
+#define FAST_SIN_C3 -0.0001981069071916863322258f
+#define FAST_SIN_C4 2.6083159809786593541503e-06f
+
+static inline float FastSinf(float x) {
+    // Round to nearest by pushing the value through the 2^23 mantissa limit;
+    // the last mantissa bit of the shifted value is then the parity of k,
+    // read without converting kf to an integer
+    float shifted = x * FAST_SIN_INV_PI + 12582912.0f;
+    float kf = shifted - 12582912.0f;
+    unsigned int bits;
+    memcpy(&bits, &shifted, sizeof(bits));
+
+    float r = x - kf * FAST_SIN_PI_A;
+    r = r - kf * FAST_SIN_PI_B;
+    r = r - kf * FAST_SIN_PI_C;
+    r = r - kf * FAST_SIN_PI_D;
+
+    float s = r * r;
+    float u = FAST_SIN_C4;
+    u = u * s + FAST_SIN_C3;
+    u = u * s + FAST_SIN_C2;
+    u = u * s + FAST_SIN_C1;
+    float y = r + r * s * u;
+
+    y = (bits & 1) ? -y : y;
+    return fabsf(kf) <= FAST_SIN_K_MAX ? y : NAN;
+}
+
+#ifdef FAST_SIN_X86
+
+// 4 lanes, SSE2 only (mul + add, no FMA)
+__attribute__((target("sse2")))
+static inline __m128 FastSin4(__m128 x) {
+    __m128i k = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(FAST_SIN_INV_PI)));
+    __m128 kf = _mm_cvtepi32_ps(k);
+
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(kf, _mm_set1_ps(FAST_SIN_PI_A)));
+    r = _mm_sub_ps(r, _mm_mul_ps(kf, _mm_set1_ps(FAST_SIN_PI_B)));
+    r = _mm_sub_ps(r, _mm_mul_ps(kf, _mm_set1_ps(FAST_SIN_PI_C)));
+    r = _mm_sub_ps(r, _mm_mul_ps(kf, _mm_set1_ps(FAST_SIN_PI_D)));
+
+    __m128 s = _mm_mul_ps(r, r);
+    __m128 u = _mm_set1_ps(FAST_SIN_C4);
+    u = _mm_add_ps(_mm_mul_ps(u, s), _mm_set1_ps(FAST_SIN_C3));
+    u = _mm_add_ps(_mm_mul_ps(u, s), _mm_set1_ps(FAST_SIN_C2));
+    u = _mm_add_ps(_mm_mul_ps(u, s), _mm_set1_ps(FAST_SIN_C1));
+    __m128 y = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, s), u));
+
+    // Odd k flips the sign: move bit 0 of k into the float sign bit
+    __m128i sign = _mm_slli_epi32(_mm_and_si128(k, _mm_set1_epi32(1)), 31);
+    y = _mm_xor_ps(y, _mm_castsi128_ps(sign));
+
+    // Out of range (or NaN, which compares unordered): all bits set, a NaN
+    __m128 absK = _mm_and_ps(kf, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+    return _mm_or_ps(y, _mm_cmpnle_ps(absK, _mm_set1_ps(FAST_SIN_K_MAX)));
+}
+
+// 8 lanes, AVX2 + FMA
+__attribute__((target("avx2,fma")))
+static inline __m256 FastSin8(__m256 x) {
+    __m256i k = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(FAST_SIN_INV_PI)));
+    __m256 kf = _mm256_cvtepi32_ps(k);
+
+    __m256 r = _mm256_fnmadd_ps(kf, _mm256_set1_ps(FAST_SIN_PI_A), x);
+    r = _mm256_fnmadd_ps(kf, _mm256_set1_ps(FAST_SIN_PI_B), r);
+    r = _mm256_fnmadd_ps(kf, _mm256_set1_ps(FAST_SIN_PI_C), r);
+    r = _mm256_fnmadd_ps(kf, _mm256_set1_ps(FAST_SIN_PI_D), r);
+
+    __m256 s = _mm256_mul_ps(r, r);
+    __m256 u = _mm256_set1_ps(FAST_SIN_C4);
+    u = _mm256_fmadd_ps(u, s, _mm256_set1_ps(FAST_SIN_C3));
+    u = _mm256_fmadd_ps(u, s, _mm256_set1_ps(FAST_SIN_C2));
+    u = _mm256_fmadd_ps(u, s, _mm256_set1_ps(FAST_SIN_C1));
+    __m256 y = _mm256_fmadd_ps(_mm256_mul_ps(r, s), u, r);
+
+    __m256i sign = _mm256_slli_epi32(_mm256_and_si256(k, _mm256_set1_epi32(1)), 31);
+    y = _mm256_xor_ps(y, _mm256_castsi256_ps(sign));
+
+    __m256 absK = _mm256_and_ps(kf, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)));
+    return _mm256_or_ps(y, _mm256_cmp_ps(absK, _mm256_set1_ps(FAST_SIN_K_MAX), _CMP_NLE_UQ));
+}
+
+// 16 lanes, AVX-512F
+__attribute__((target("avx512f")))
+static inline __m512 FastSin16(__m512 x) {
+    __m512i k = _mm512_cvtps_epi32(_mm512_mul_ps(x, _mm512_set1_ps(FAST_SIN_INV_PI)));
+    __m512 kf = _mm512_cvtepi32_ps(k);
+
+    __m512 r = _mm512_fnmadd_ps(kf, _mm512_set1_ps(FAST_SIN_PI_A), x);
+    r = _mm512_fnmadd_ps(kf, _mm512_set1_ps(FAST_SIN_PI_B), r);
+    r = _mm512_fnmadd_ps(kf, _mm512_set1_ps(FAST_SIN_PI_C), r);
+    r = _mm512_fnmadd_ps(kf, _mm512_set1_ps(FAST_SIN_PI_D), r);
+
+    __m512 s = _mm512_mul_ps(r, r);
+    __m512 u = _mm512_set1_ps(FAST_SIN_C4);
+    u = _mm512_fmadd_ps(u, s, _mm512_set1_ps(FAST_SIN_C3));
+    u = _mm512_fmadd_ps(u, s, _mm512_set1_ps(FAST_SIN_C2));
+    u = _mm512_fmadd_ps(u, s, _mm512_set1_ps(FAST_SIN_C1));
+    __m512 y = _mm512_fmadd_ps(_mm512_mul_ps(r, s), u, r);
+
+    __m512i sign = _mm512_slli_epi32(_mm512_and_si512(k, _mm512_set1_epi32(1)), 31);
+    y = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(y), sign));
+
+    __mmask16 outside = _mm512_cmp_ps_mask(_mm512_abs_ps(kf), _mm512_set1_ps(FAST_SIN_K_MAX), _CMP_NLE_UQ);
+    return _mm512_mask_mov_ps(y, outside, _mm512_set1_ps(NAN));
+}
+
+#endif // FAST_SIN_X86
+
+#endif // FAST_SIN_H
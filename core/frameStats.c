@@ -0,0 +1,137 @@
+#include "frameStats.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "timing.h"
+
+const char *framePhaseNames[FRAME_PHASE_COUNT] = {"input", "update", "collision", "draw", "present"};
+
+static int BinOf(double seconds) {
+    if (!(seconds > 0.0)) return 0;
+    double bin = seconds / FRAME_STATS_BIN_SECONDS;
+    return bin >= FRAME_STATS_BINS - 1 ? FRAME_STATS_BINS - 1 : (int)bin;
+}
+
+void FrameStatsInit(FrameStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->startTime = GetHighPrecisionTime();
+    stats->frameStart = stats->startTime;
+    stats->phaseStart = stats->startTime;
+}
+
+void FrameStatsFree(FrameStats *stats) {
+    if (stats->csv != NULL) fclose(stats->csv);
+    stats->csv = NULL;
+}
+
+bool FrameStatsOpenCsv(FrameStats *stats, const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) return false;
+    if (stats->csv != NULL) fclose(stats->csv);
+    stats->csv = file;
+    fprintf(file, "frame,time_s,frame_ms");
+    for (int phase = 0; phase < FRAME_PHASE_COUNT; phase++) fprintf(file, ",%s_ms", framePhaseNames[phase]);
+    fprintf(file, "\n");
+    return true;
+}
+
+const char *FrameStatsOpenCsvFromEnvironment(FrameStats *stats) {
+    const char *path = getenv("BALLCORE_FRAME_CSV");
+    if (path == NULL || path[0] == '\0') return NULL;
+    return FrameStatsOpenCsv(stats, path) ? path : NULL;
+}
+
+void FrameStatsEndPhase(FrameStats *stats, int phase) {
+    double now = GetHighPrecisionTime();
+    stats->phases[phase] += now - stats->phaseStart;
+    stats->phaseStart = now;
+}
+
+void FrameStatsAddPhase(FrameStats *stats, int phase, double seconds) {
+    stats->phases[phase] += seconds;
+}
+
+void FrameStatsEndFrame(FrameStats *stats) {
+    double now = GetHighPrecisionTime();
+    double frameTime = now - stats->frameStart;
+    int slot = stats->next;
+
+    if (stats->count == FRAME_STATS_WINDOW) {
+        stats->bins[BinOf(stats->frameTime[slot])]--;
+    } else {
+        stats->count++;
+    }
+    stats->bins[BinOf(frameTime)]++;
+    stats->frameTime[slot] = frameTime;
+    memcpy(stats->phaseTime[slot], stats->phases, sizeof(stats->phases));
+    stats->next = (slot + 1) % FRAME_STATS_WINDOW;
+
+    if (stats->csv != NULL) {
+        fprintf(stats->csv, "%lld,%.6f,%.4f", stats->frames, stats->frameStart - stats->startTime, frameTime * 1e3);
+        for (int phase = 0; phase < FRAME_PHASE_COUNT; phase++) fprintf(stats->csv, ",%.4f", stats->phases[phase] * 1e3);
+        fprintf(stats->csv, "\n");
+        if ((stats->frames + 1) % FRAME_STATS_WINDOW == 0) fflush(stats->csv);
+    }
+
+    stats->frames++;
+    stats->frameStart = now;
+    stats->phaseStart = now;
+    memset(stats->phases, 0, sizeof(stats->phases));
+}
+
+static double Worst(const FrameStats *stats) {
+    double worst = 0.0;
+    for (int i = 0; i < stats->count; i++) {
+        if (stats->frameTime[i] > worst) worst = stats->frameTime[i];
+    }
+    return worst;
+}
+
+double FrameStatsPercentile(const FrameStats *stats, double p) {
+    if (stats->count == 0) return 0.0;
+    // The frame of rank ceil(p% of count), counting from 1
+    int rank = (int)ceil(p * stats->count / 100.0);
+    if (rank < 1) rank = 1;
+    if (rank > stats->count) rank = stats->count;
+
+    int seen = 0, bin = 0;
+    while (bin < FRAME_STATS_BINS - 1) {
+        seen += stats->bins[bin];
+        if (seen >= rank) break;
+        bin++;
+    }
+    return bin == FRAME_STATS_BINS - 1 ? Worst(stats) : (bin + 1) * FRAME_STATS_BIN_SECONDS;
+}
+
+void FrameStatsSummarize(const FrameStats *stats, FrameSummary *summary) {
+    memset(summary, 0, sizeof(*summary));
+    summary->frames = stats->count;
+    if (stats->count == 0) return;
+
+    for (int i = 0; i < stats->count; i++) {
+        summary->mean += stats->frameTime[i];
+        for (int phase = 0; phase < FRAME_PHASE_COUNT; phase++) summary->phases[phase] += stats->phaseTime[i][phase];
+    }
+    summary->mean /= stats->count;
+    for (int phase = 0; phase < FRAME_PHASE_COUNT; phase++) summary->phases[phase] /= stats->count;
+    summary->p50 = FrameStatsPercentile(stats, 50.0);
+    summary->p95 = FrameStatsPercentile(stats, 95.0);
+    summary->p99 = FrameStatsPercentile(stats, 99.0);
+    summary->worst = Worst(stats);
+}
+
+int FrameStatsHistogram(const FrameStats *stats, int *counts, int buckets, double bucketSeconds) {
+    memset(counts, 0, sizeof(int) * buckets);
+    for (int bin = 0; bin < FRAME_STATS_BINS; bin++) {
+        if (stats->bins[bin] == 0) continue;
+        // Bin centres, so bins never straddle a bucket edge by rounding
+        int bucket = (int)((bin + 0.5) * FRAME_STATS_BIN_SECONDS / bucketSeconds);
+        if (bucket >= buckets || bin == FRAME_STATS_BINS - 1) bucket = buckets - 1;
+        counts[bucket] += stats->bins[bin];
+    }
+    int largest = 0;
+    for (int bucket = 0; bucket < buckets; bucket++) {
+        if (counts[bucket] > largest) largest = counts[bucket];
+    }
+    return largest;
+}
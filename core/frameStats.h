@@ -0,0 +1,101 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+// Rolling frame-time statistics for the windowed demos.
+//
+// Each frame is split into phases on the clock (GetHighPrecisionTime):
+//
+//   FrameStatsEndPhase(&stats, FRAME_PHASE_INPUT);   // Time since the last mark
+//   ...
+//   FrameStatsEndFrame(&stats);                      // Time since the last frame
+//
+// Work measured elsewhere, such as a simulation tick on another thread, is
+// added with FrameStatsAddPhase. The frame time is the time between two
+// FrameStatsEndFrame calls, so it includes the wait for vsync and anything
+// that was not marked.
+//
+// The last FRAME_STATS_WINDOW frames are kept in a ring together with a
+// histogram of their frame times in FRAME_STATS_BIN_SECONDS bins. Pushing a
+// frame moves one count from the evicted frame's bin to the new frame's
+// bin, so percentiles cost one scan of the bins and no sorting. They are
+// exact to one bin width.
+//
+// With a CSV file open, every frame is also written as one row of
+// milliseconds: frame,time_s,frame_ms,input_ms,update_ms,collision_ms,
+// draw_ms,present_ms. Rows are flushed once per window, so a run that is
+// killed loses at most the last window.
+
+#define FRAME_PHASE_INPUT 0
+#define FRAME_PHASE_UPDATE 1
+#define FRAME_PHASE_COLLISION 2
+#define FRAME_PHASE_DRAW 3
+#define FRAME_PHASE_PRESENT 4
+#define FRAME_PHASE_COUNT 5
+
+#define FRAME_STATS_WINDOW 600          // Frames kept (10 seconds at 60 fps)
+#define FRAME_STATS_BINS 1000           // Histogram bins; slower frames go in the last
+#define FRAME_STATS_BIN_SECONDS 0.0001  // Bin width (0.1 ms, so 0 to 100 ms)
+
+extern const char *framePhaseNames[FRAME_PHASE_COUNT];
+
+typedef struct {
+    double frameTime[FRAME_STATS_WINDOW];                  // Seconds, ring
+    double phaseTime[FRAME_STATS_WINDOW][FRAME_PHASE_COUNT];
+    int bins[FRAME_STATS_BINS];                            // Window frames per bin
+    int count;                                             // Frames in the window
+    int next;                                              // Ring slot of the next frame
+    long long frames;                                      // Frames since FrameStatsInit
+    double startTime;                                      // FrameStatsInit
+    double frameStart;                                     // End of the last frame
+    double phaseStart;                                     // Last mark
+    double phases[FRAME_PHASE_COUNT];                      // Current frame
+    FILE *csv;                                             // NULL when not streaming
+} FrameStats;
+
+typedef struct {
+    int frames;                          // Frames in the window
+    double mean;                         // Frame time in seconds
+    double p50;
+    double p95;
+    double p99;
+    double worst;
+    double phases[FRAME_PHASE_COUNT];    // Mean seconds per frame
+} FrameSummary;
+
+// The first frame starts now
+void FrameStatsInit(FrameStats *stats);
+void FrameStatsFree(FrameStats *stats);
+
+// Stream every frame to a CSV file from now on; returns false when the file
+// cannot be created
+bool FrameStatsOpenCsv(FrameStats *stats, const char *path);
+
+// Open the CSV file named by BALLCORE_FRAME_CSV, and return the name (NULL
+// when it is unset or cannot be created)
+const char *FrameStatsOpenCsvFromEnvironment(FrameStats *stats);
+
+// Charge the time since the last mark (or the end of the last frame) to `phase`
+void FrameStatsEndPhase(FrameStats *stats, int phase);
+
+// Charge `seconds` measured elsewhere to `phase` of the current frame
+void FrameStatsAddPhase(FrameStats *stats, int phase, double seconds);
+
+// Close the current frame: push it into the window and the CSV file, and
+// start the next one
+void FrameStatsEndFrame(FrameStats *stats);
+
+// Frame time percentile `p` (0 to 100) over the window: the upper edge of
+// the bin it falls in, or the slowest frame when that is in the last bin
+double FrameStatsPercentile(const FrameStats *stats, double p);
+
+void FrameStatsSummarize(const FrameStats *stats, FrameSummary *summary);
+
+// Window frames per `bucketSeconds`-wide bucket of frame time, for
+// `buckets` buckets from 0; the last bucket also holds every slower frame.
+// Returns the largest count.
+int FrameStatsHistogram(const FrameStats *stats, int *counts, int buckets, double bucketSeconds);
+
+#endif // FRAME_STATS_H
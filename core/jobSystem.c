@@ -0,0 +1,250 @@
+#define _POSIX_C_SOURCE 200112L
+#include "jobSystem.h"
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "trace.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define JOB_PAUSE() __builtin_ia32_pause()
+#else
+#define JOB_PAUSE() ((void)0)
+#endif
+
+#define JOB_SPINS_BEFORE_YIELD 64
+
+typedef struct {
+    JobSystem *jobs;
+    int index;
+} WorkerStart;
+
+// ---------------------------------------------------------------------------
+// Chase-Lev deque (Le, Pop, Cohen, Zappa Nardelli 2013, C11 memory orders).
+// Ranges are packed into one 64-bit word so a thief's read of a slot is a
+// single atomic load.
+// ---------------------------------------------------------------------------
+
+static unsigned long long PackRange(int begin, int end) {
+    return (unsigned)begin | ((unsigned long long)(unsigned)end << 32);
+}
+
+static void UnpackRange(unsigned long long range, int *begin, int *end) {
+    *begin = (int)(unsigned)range;
+    *end = (int)(unsigned)(range >> 32);
+}
+
+// Owner only
+static void DequePush(JobDeque *deque, unsigned long long range) {
+    long long b = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    __atomic_store_n(&deque->ranges[b & (JOB_DEQUE_CAPACITY - 1)], range, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&deque->bottom, b + 1, __ATOMIC_RELAXED);
+}
+
+// Owner only: newest range, false when empty
+static bool DequeTake(JobDeque *deque, unsigned long long *range) {
+    long long b = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&deque->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long long t = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+    if (t > b) {
+        __atomic_store_n(&deque->bottom, b + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    *range = __atomic_load_n(&deque->ranges[b & (JOB_DEQUE_CAPACITY - 1)], __ATOMIC_RELAXED);
+    if (t == b) {
+        // Last range: race the thieves for it
+        bool won = __atomic_compare_exchange_n(&deque->top, &t, t + 1, false,
+                                               __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&deque->bottom, b + 1, __ATOMIC_RELAXED);
+        return won;
+    }
+    return true;
+}
+
+// Any thread: oldest (largest) range, false when empty or lost to another thief
+static bool DequeSteal(JobDeque *deque, unsigned long long *range) {
+    long long t = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long long b = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+
+    if (t >= b) return false;
+    *range = __atomic_load_n(&deque->ranges[t & (JOB_DEQUE_CAPACITY - 1)], __ATOMIC_RELAXED);
+    return __atomic_compare_exchange_n(&deque->top, &t, t + 1, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+// ---------------------------------------------------------------------------
+// Loop execution
+// ---------------------------------------------------------------------------
+
+// Split off upper halves (on grain boundaries) until the range fits in one
+// grain, then run it
+static void RunRange(JobSystem *jobs, JobDeque *own, unsigned long long range) {
+    int begin, end;
+    UnpackRange(range, &begin, &end);
+
+    while (end - begin > jobs->grain) {
+        int mid = begin + (end - begin) / 2 / jobs->grain * jobs->grain;
+        if (mid == begin) mid += jobs->grain;
+        DequePush(own, PackRange(mid, end));
+        end = mid;
+    }
+    jobs->function(jobs->context, begin, end);
+    __atomic_sub_fetch(&jobs->remaining, end - begin, __ATOMIC_ACQ_REL);
+}
+
+// Take and steal ranges until every item of the current loop is done
+static void WorkOnLoop(JobSystem *jobs, int index) {
+    JobDeque *own = &jobs->deques[index];
+    unsigned seed = 2654435761u * (unsigned)(index + 1);
+    int idle = 0;
+
+    while (__atomic_load_n(&jobs->remaining, __ATOMIC_ACQUIRE) > 0) {
+        unsigned long long range;
+        if (DequeTake(own, &range)) {
+            RunRange(jobs, own, range);
+            idle = 0;
+            continue;
+        }
+
+        // xorshift victim choice keeps thieves from piling onto one deque
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        int victim = (int)(seed % (unsigned)jobs->workerCount);
+        if (victim != index && DequeSteal(&jobs->deques[victim], &range)) {
+            RunRange(jobs, own, range);
+            idle = 0;
+        } else if (++idle < JOB_SPINS_BEFORE_YIELD) {
+            JOB_PAUSE();
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+static void *WorkerMain(void *argument) {
+    WorkerStart start = *(WorkerStart *)argument;
+    JobSystem *jobs = start.jobs;
+    unsigned seen = 0;
+
+    free(argument);
+    TraceThreadName("worker");
+
+    for (;;) {
+        // Join a loop only while it still has items left; JobSystemParallelFor
+        // checks `active` under the same mutex, so no helper can join a loop
+        // after its caller has returned
+        pthread_mutex_lock(&jobs->mutex);
+        while (jobs->generation == seen && !jobs->quit) {
+            pthread_cond_wait(&jobs->wake, &jobs->mutex);
+        }
+        if (jobs->quit) {
+            pthread_mutex_unlock(&jobs->mutex);
+            return NULL;
+        }
+        seen = jobs->generation;
+        bool join = __atomic_load_n(&jobs->remaining, __ATOMIC_ACQUIRE) > 0;
+        if (join) jobs->active++;
+        pthread_mutex_unlock(&jobs->mutex);
+
+        if (!join) continue;
+        TRACE_BEGIN(zone, "jobs");
+        WorkOnLoop(jobs, start.index);
+        TRACE_END(zone);
+
+        pthread_mutex_lock(&jobs->mutex);
+        if (--jobs->active == 0) pthread_cond_signal(&jobs->done);
+        pthread_mutex_unlock(&jobs->mutex);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+int JobSystemCpuCount(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
+bool JobSystemInit(JobSystem *jobs, int workerCount) {
+    if (workerCount <= 0) workerCount = JobSystemCpuCount();
+    if (workerCount > JOB_MAX_WORKERS) workerCount = JOB_MAX_WORKERS;
+
+    jobs->workerCount = 1;
+    jobs->generation = 0;
+    jobs->active = 0;
+    jobs->quit = false;
+    jobs->function = NULL;
+    jobs->context = NULL;
+    jobs->grain = 1;
+    jobs->remaining = 0;
+    for (int i = 0; i < JOB_MAX_WORKERS; i++) {
+        jobs->deques[i].top = 0;
+        jobs->deques[i].bottom = 0;
+    }
+    if (pthread_mutex_init(&jobs->mutex, NULL) != 0) return false;
+    pthread_cond_init(&jobs->wake, NULL);
+    pthread_cond_init(&jobs->done, NULL);
+
+    // Fewer threads than asked for is still a working pool
+    for (int i = 1; i < workerCount; i++) {
+        WorkerStart *start = malloc(sizeof(WorkerStart));
+        if (start == NULL) break;
+        *start = (WorkerStart){jobs, i};
+        if (pthread_create(&jobs->threads[i], NULL, WorkerMain, start) != 0) {
+            free(start);
+            break;
+        }
+        jobs->workerCount = i + 1;
+    }
+    return true;
+}
+
+void JobSystemFree(JobSystem *jobs) {
+    pthread_mutex_lock(&jobs->mutex);
+    jobs->quit = true;
+    pthread_cond_broadcast(&jobs->wake);
+    pthread_mutex_unlock(&jobs->mutex);
+
+    for (int i = 1; i < jobs->workerCount; i++) {
+        pthread_join(jobs->threads[i], NULL);
+    }
+    pthread_cond_destroy(&jobs->done);
+    pthread_cond_destroy(&jobs->wake);
+    pthread_mutex_destroy(&jobs->mutex);
+    jobs->workerCount = 0;
+}
+
+void JobSystemParallelFor(JobSystem *jobs, int count, int grain, JobFunction function, void *context) {
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+
+    // Small loops or a single worker: no point waking anybody
+    if (count <= grain || jobs->workerCount == 1) {
+        function(context, 0, count);
+        return;
+    }
+
+    pthread_mutex_lock(&jobs->mutex);
+    jobs->function = function;
+    jobs->context = context;
+    jobs->grain = grain;
+    __atomic_store_n(&jobs->remaining, count, __ATOMIC_RELEASE);
+    DequePush(&jobs->deques[0], PackRange(0, count));
+    jobs->generation++;
+    pthread_cond_broadcast(&jobs->wake);
+    pthread_mutex_unlock(&jobs->mutex);
+
+    WorkOnLoop(jobs, 0);
+
+    // Helpers may still be between their last range and leaving the loop
+    pthread_mutex_lock(&jobs->mutex);
+    while (jobs->active > 0) {
+        pthread_cond_wait(&jobs->done, &jobs->mutex);
+    }
+    pthread_mutex_unlock(&jobs->mutex);
+}
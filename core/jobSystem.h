@@ -0,0 +1,67 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <stdbool.h>
+#include <pthread.h>
+
+// Work-stealing thread pool for data-parallel loops.
+//
+// JobSystemParallelFor splits [0, count) into ranges of at most `grain`
+// items. Every worker owns a Chase-Lev deque: it takes ranges from its own
+// bottom end and, when that runs dry, steals from the top of a random
+// other worker's deque. Ranges are split lazily: a worker that picks up a
+// large range pushes its upper half back and keeps the lower half, so a
+// whole loop starts as one push and spreads out only as fast as workers
+// come looking for work. Uneven chunks (e.g. balls that hit something)
+// therefore balance themselves without a central queue.
+//
+// The calling thread is worker 0 and runs ranges too; idle workers sleep on
+// a condition variable between loops. Loops must not be nested, and only
+// one thread may call JobSystemParallelFor at a time.
+
+#define JOB_MAX_WORKERS 64
+#define JOB_DEQUE_CAPACITY 64  // Lazy splitting keeps at most ~log2(count) ranges queued
+
+// Run items [begin, end) of the loop
+typedef void (*JobFunction)(void *context, int begin, int end);
+
+// Thieves write `top` and the owner writes `bottom`; each gets its own
+// cache line so the owner's pushes and pops do not bounce it
+typedef struct {
+    long long top __attribute__((aligned(64)));     // Steal end, advanced by CAS
+    long long bottom __attribute__((aligned(64)));  // Owner end
+    unsigned long long ranges[JOB_DEQUE_CAPACITY];  // begin | end << 32
+} JobDeque;
+
+typedef struct {
+    int workerCount;              // Including the calling thread
+    pthread_t threads[JOB_MAX_WORKERS];
+    JobDeque deques[JOB_MAX_WORKERS];
+
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;          // A new loop started (or shutdown)
+    pthread_cond_t done;          // The last helper left the current loop
+    unsigned generation;          // Loops started so far
+    int active;                   // Helpers inside the current loop
+    bool quit;
+
+    // Current loop
+    JobFunction function;
+    void *context;
+    int grain;
+    long long remaining;          // Items not finished yet
+} JobSystem;
+
+// Start workerCount - 1 threads (0 means one worker per online CPU). The
+// system must stay at the same address until JobSystemFree.
+bool JobSystemInit(JobSystem *jobs, int workerCount);
+void JobSystemFree(JobSystem *jobs);
+
+// Online CPUs, at least 1
+int JobSystemCpuCount(void);
+
+// Call function over [0, count) in ranges of at most `grain` items, on all
+// workers, and return once every item is done
+void JobSystemParallelFor(JobSystem *jobs, int count, int grain, JobFunction function, void *context);
+
+#endif // JOB_SYSTEM_H
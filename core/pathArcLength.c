@@ -0,0 +1,136 @@
+#include "pathArcLength.h"
+#include <math.h>
+#include <stdlib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PATH_ARC_X86 1
+#endif
+
+// Length of the chord from t0 to t1 on the exact path
+static double ChordLength(int path, double t0, double t1) {
+    double x0, y0, x1, y1;
+    PathEvaluateReference(path, t0, &x0, &y0);
+    PathEvaluateReference(path, t1, &x1, &y1);
+    if (path == PATH_ANGULAR && t0 < 0.5 && t1 >= 0.5) y1 = y0;  // The step is a jump, not travel
+    return hypot(x1 - x0, y1 - y0);
+}
+
+bool PathArcTableInit(PathArcTable *table, int path, int resolution) {
+    if (resolution < 1 || path < 0 || path >= PATH_COUNT) return false;
+
+    // Cumulative chord lengths over the fine grid
+    int fine = resolution * PATH_ARC_OVERSAMPLE;
+    double *cumulative = malloc(sizeof(double) * ((size_t)fine + 1));
+    table->t = malloc(sizeof(float) * ((size_t)resolution + 2));
+    if (cumulative == NULL || table->t == NULL) {
+        free(cumulative);
+        free(table->t);
+        table->t = NULL;
+        return false;
+    }
+    cumulative[0] = 0.0;
+    for (int j = 1; j <= fine; j++) {
+        cumulative[j] = cumulative[j - 1] + ChordLength(path, (double)(j - 1) / fine, (double)j / fine);
+    }
+    double length = cumulative[fine];
+
+    // Invert: walk the fine grid once, placing each even distance inside
+    // its chord (distances only grow, so the walk never goes back)
+    int j = 0;
+    for (int k = 0; k <= resolution; k++) {
+        double target = length * k / resolution;
+        while (j < fine - 1 && cumulative[j + 1] < target) j++;
+        double chord = cumulative[j + 1] - cumulative[j];
+        double f = chord > 0.0 ? (target - cumulative[j]) / chord : 0.0;
+        if (f > 1.0) f = 1.0;
+        table->t[k] = (float)((j + f) / fine);
+    }
+    table->t[resolution + 1] = table->t[resolution];  // distance == length reads one past the end
+    free(cumulative);
+
+    table->path = path;
+    table->resolution = resolution;
+    table->length = (float)length;
+    table->scale = (float)(resolution / length);
+    return true;
+}
+
+void PathArcTableFree(PathArcTable *table) {
+    free(table->t);
+    table->t = NULL;
+    table->resolution = 0;
+}
+
+size_t PathArcTableBytes(const PathArcTable *table) {
+    return sizeof(float) * (size_t)(table->resolution + 2);
+}
+
+// The clamp is maxss/minss (a plain C compare-select still compiles to a
+// branch, and fminf/fmaxf to libm calls); the guard entry makes
+// u == resolution safe
+static inline float LookupT(const float *t, float limit, float scale, float distance) {
+#ifdef PATH_ARC_X86
+    __m128 clamped = _mm_min_ss(_mm_max_ss(_mm_set_ss(distance * scale), _mm_setzero_ps()), _mm_set_ss(limit));
+    float u = _mm_cvtss_f32(clamped);
+#else
+    float u = distance * scale;
+    u = u < 0.0f ? 0.0f : u;
+    u = u < limit ? u : limit;
+#endif
+    int i = (int)u;
+    float f = u - (float)i;
+    return t[i] + f * (t[i + 1] - t[i]);
+}
+
+float PathArcTableT(const PathArcTable *table, float distance) {
+    return LookupT(table->t, (float)table->resolution, table->scale, distance);
+}
+
+void PathArcTableTBatch(const PathArcTable *table, const float *distance, float *t, int count) {
+    // Locals, so the stores to t cannot force a reload of *table
+    const float *values = table->t;
+    const float limit = (float)table->resolution;
+    const float scale = table->scale;
+    int i = 0;
+#ifdef PATH_ARC_X86
+    // Four lookups at a time: the clamp, split and lerp run in SSE registers
+    // and only the two table fetches per lane are scalar
+    const __m128 scaleVector = _mm_set1_ps(scale);
+    const __m128 limitVector = _mm_set1_ps(limit);
+    for (; i + 4 <= count; i += 4) {
+        __m128 u = _mm_mul_ps(_mm_loadu_ps(distance + i), scaleVector);
+        u = _mm_min_ps(_mm_max_ps(u, _mm_setzero_ps()), limitVector);
+        __m128i index = _mm_cvttps_epi32(u);
+        __m128 f = _mm_sub_ps(u, _mm_cvtepi32_ps(index));
+        int lanes[4];
+        _mm_storeu_si128((__m128i *)lanes, index);
+        __m128 t0 = _mm_setr_ps(values[lanes[0]], values[lanes[1]], values[lanes[2]], values[lanes[3]]);
+        __m128 t1 = _mm_setr_ps(values[lanes[0] + 1], values[lanes[1] + 1], values[lanes[2] + 1], values[lanes[3] + 1]);
+        _mm_storeu_ps(t + i, _mm_add_ps(t0, _mm_mul_ps(f, _mm_sub_ps(t1, t0))));
+    }
+#endif
+    for (; i < count; i++) {
+        t[i] = LookupT(values, limit, scale, distance[i]);
+    }
+}
+
+double PathArcTableMaxError(const PathArcTable *table, int samples) {
+    // Exact arc length of the returned t, by chords much finer than the
+    // table's; the distances are visited in order so the length accumulates
+    const int steps = 64;
+    double maxError = 0.0, arc = 0.0, arcT = 0.0;
+    for (int i = 0; i < samples; i++) {
+        double distance = samples > 1 ? (double)table->length * i / (samples - 1) : 0.0;
+        double t = PathArcTableT(table, (float)distance);
+        if (t > arcT) {
+            for (int s = 0; s < steps; s++) {
+                arc += ChordLength(table->path, arcT + (t - arcT) * s / steps, arcT + (t - arcT) * (s + 1) / steps);
+            }
+            arcT = t;
+        }
+        double error = fabs(arc - distance);
+        if (error > maxError) maxError = error;
+    }
+    return maxError;
+}
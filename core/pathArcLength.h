@@ -0,0 +1,51 @@
+#ifndef PATH_ARC_LENGTH_H
+#define PATH_ARC_LENGTH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "paths.h"
+
+// Arc-length tables for constant-speed motion.
+//
+// Every path runs x = t * SCREEN_WIDTH, so stepping t evenly moves the ball
+// at a speed that follows the slope: on the sinusoidal path it varies
+// several-fold over a cycle. A table maps distance travelled along the path
+// (pixels from t = 0) back to t, so a ball can advance by distance and then
+// be placed with the usual path function.
+//
+// The table is built once from cumulative chord lengths over a fine grid of
+// t (PATH_ARC_OVERSAMPLE points per table interval, double precision), then
+// inverted onto `resolution + 1` evenly spaced distances. A lookup is a
+// multiply, a clamp with min/max, one interval fetch and a lerp, with no
+// branches or searches, about the cost of evaluating the path itself.
+//
+// The angular path jumps 200 px at t = 0.5; the ball teleports there, so the
+// jump adds no length.
+
+#define PATH_ARC_OVERSAMPLE 16
+
+typedef struct {
+    int path;         // PATH_* id the table was built for
+    int resolution;   // Number of intervals across the length
+    float length;     // Path length in pixels from t = 0 to 1
+    float scale;      // resolution / length (distance -> table position)
+    float *t;         // t at resolution + 1 even distances, plus a guard copy of the last
+} PathArcTable;
+
+bool PathArcTableInit(PathArcTable *table, int path, int resolution);
+void PathArcTableFree(PathArcTable *table);
+
+// Footprint of the table in bytes
+size_t PathArcTableBytes(const PathArcTable *table);
+
+// t at `distance` pixels along the path, clamped to [0, length]
+float PathArcTableT(const PathArcTable *table, float distance);
+
+// PathArcTableT for `count` distances
+void PathArcTableTBatch(const PathArcTable *table, const float *distance, float *t, int count);
+
+// Largest gap in pixels between a requested distance and the exact arc
+// length at the t returned for it, over `samples` even distances
+double PathArcTableMaxError(const PathArcTable *table, int samples);
+
+#endif // PATH_ARC_LENGTH_H
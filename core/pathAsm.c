@@ -0,0 +1,102 @@
+#include "paths.h"
+#include "fastSin.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// Optimized path calculations using inline assembly
+Vector2 CalculateStraightPathAsm(float t) {
+    float x;
+    float screenWidth = SCREEN_WIDTH;  // Load SCREEN_WIDTH into a local variable
+    __asm__ volatile (
+        "mulss %[screenWidth], %[t]\n"  // t * SCREEN_WIDTH
+        "movss %[t], %[x]\n"            // Store result in x
+        : [x] "=m" (x), [t] "+x" (t)
+        : [screenWidth] "x" (screenWidth)
+        : 
+    );
+    return (Vector2){x, SCREEN_HEIGHT / 2.0f};
+}
+
+Vector2 CalculateAngularPathAsm(float t) {
+    float x, y_offset;
+    float screenWidth = SCREEN_WIDTH;  // Load SCREEN_WIDTH into a local variable
+    float half = 0.5f, plus_offset = 100.0f, minus_offset = -100.0f;
+
+    __asm__ volatile (
+        // Compute y_offset based on t < 0.5 (before t is scaled below)
+        "movss %[t], %%xmm0\n"
+        "ucomiss %[half], %%xmm0\n"
+
+        // Compute x = t * SCREEN_WIDTH (mulss leaves the flags alone)
+        "mulss %[screenWidth], %[t]\n"
+        "movss %[t], %[x]\n"
+
+        "jb 1f\n"
+        "movss %[plus_offset], %[y_offset]\n"
+        "jmp 2f\n"
+        "1: movss %[minus_offset], %[y_offset]\n"
+        "2:\n"
+
+        : [x] "=m" (x), [y_offset] "=m" (y_offset), [t] "+x" (t)
+        : [screenWidth] "x" (screenWidth),
+          [half] "x" (half), [plus_offset] "x" (plus_offset), [minus_offset] "x" (minus_offset)
+        : "xmm0"
+    );
+
+    return (Vector2){x, (SCREEN_HEIGHT / 2.0f) + y_offset};
+}
+
+Vector2 CalculateConvexPathAsm(float t) {
+    float x, y;
+    float screenWidth = SCREEN_WIDTH;  // Load SCREEN_WIDTH into a local variable
+    float pi = (float)M_PI, neg_amp = -200.0f, offset = SCREEN_HEIGHT / 2.0f;
+
+    // Compute y with the polynomial sine instead of a libm call
+    y = offset + neg_amp * FastSinf(t * pi);
+
+    __asm__ volatile (
+        // Compute x = t * SCREEN_WIDTH
+        "mulss %[screenWidth], %[t]\n"
+        "movss %[t], %[x]\n"
+
+        : [x] "=m" (x), [t] "+x" (t)
+        : [screenWidth] "x" (screenWidth)
+        : 
+    );
+
+    return (Vector2){x, y};
+}
+
+Vector2 CalculateSinusoidalPathAsm(float t) {
+    float x, y;
+    float screenWidth = SCREEN_WIDTH;  // Load SCREEN_WIDTH into a local variable
+    float four_pi = 4.0f * M_PI, amplitude = 100.0f, offset = SCREEN_HEIGHT / 2.0f;
+
+    // Compute y with the polynomial sine instead of a libm call
+    y = offset + amplitude * FastSinf(t * four_pi);
+
+    __asm__ volatile (
+        // Compute x = t * SCREEN_WIDTH
+        "mulss %[screenWidth], %[t]\n"
+        "movss %[t], %[x]\n"
+
+        : [x] "=m" (x), [t] "+x" (t)
+        : [screenWidth] "x" (screenWidth)
+        : 
+    );
+
+    return (Vector2){x, y};
+}
+
+#else // No SSE: the asm tier is the C implementation
+
+Vector2 CalculateStraightPathAsm(float t) { return CalculateStraightPath(t); }
+Vector2 CalculateAngularPathAsm(float t) { return CalculateAngularPath(t); }
+Vector2 CalculateConvexPathAsm(float t) { return CalculateConvexPath(t); }
+Vector2 CalculateSinusoidalPathAsm(float t) { return CalculateSinusoidalPath(t); }
+
+#endif
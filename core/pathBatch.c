@@ -0,0 +1,243 @@
+#include "pathBatch.h"
+#include "cpuDispatch.h"
+#include "fastSin.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PATH_BATCH_X86 1
+#endif
+
+#define PATH_PI 3.14159265358979323846f
+#define PATH_MID (SCREEN_HEIGHT / 2.0f)
+
+// Scalar path evaluation, also used for the tails of the vector kernels
+static void StraightScalar(const float *t, float *x, float *y, int count) {
+    for (int i = 0; i < count; i++) {
+        x[i] = t[i] * SCREEN_WIDTH;
+        y[i] = PATH_MID;
+    }
+}
+
+static void AngularScalar(const float *t, float *x, float *y, int count) {
+    for (int i = 0; i < count; i++) {
+        x[i] = t[i] * SCREEN_WIDTH;
+        y[i] = PATH_MID + (t[i] < 0.5f ? -100.0f : 100.0f);
+    }
+}
+
+static void ConvexScalar(const float *t, float *x, float *y, int count) {
+    for (int i = 0; i < count; i++) {
+        x[i] = t[i] * SCREEN_WIDTH;
+        y[i] = PATH_MID - 200.0f * FastSinf(t[i] * PATH_PI);
+    }
+}
+
+static void SinusoidalScalar(const float *t, float *x, float *y, int count) {
+    for (int i = 0; i < count; i++) {
+        x[i] = t[i] * SCREEN_WIDTH;
+        y[i] = PATH_MID + 100.0f * FastSinf(t[i] * 4.0f * PATH_PI);
+    }
+}
+
+void CalculatePathBatchScalar(int path, const float *t, float *x, float *y, int count) {
+    switch (path) {
+        case PATH_STRAIGHT: StraightScalar(t, x, y, count); break;
+        case PATH_ANGULAR: AngularScalar(t, x, y, count); break;
+        case PATH_CONVEX: ConvexScalar(t, x, y, count); break;
+        case PATH_SINUSOIDAL: SinusoidalScalar(t, x, y, count); break;
+    }
+}
+
+#ifdef PATH_BATCH_X86
+
+// ---------------------------------------------------------------------------
+// SSE2: 4 lanes
+// ---------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+void CalculatePathBatchSSE(int path, const float *t, float *x, float *y, int count) {
+    const __m128 width = _mm_set1_ps((float)SCREEN_WIDTH);
+    const __m128 mid = _mm_set1_ps(PATH_MID);
+    int i = 0;
+
+    switch (path) {
+        case PATH_STRAIGHT:
+            for (; i + 4 <= count; i += 4) {
+                _mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(t + i), width));
+                _mm_storeu_ps(y + i, mid);
+            }
+            StraightScalar(t + i, x + i, y + i, count - i);
+            break;
+
+        case PATH_ANGULAR: {
+            // y = mid - 100 + 200 * (t >= 0.5), built from a compare mask
+            // instead of the ucomiss/jb branch in optimized.c
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 low = _mm_set1_ps(PATH_MID - 100.0f);
+            const __m128 step = _mm_set1_ps(200.0f);
+            for (; i + 4 <= count; i += 4) {
+                __m128 tv = _mm_loadu_ps(t + i);
+                __m128 upper = _mm_cmpge_ps(tv, half);
+                _mm_storeu_ps(x + i, _mm_mul_ps(tv, width));
+                _mm_storeu_ps(y + i, _mm_add_ps(low, _mm_and_ps(upper, step)));
+            }
+            AngularScalar(t + i, x + i, y + i, count - i);
+            break;
+        }
+
+        case PATH_CONVEX:
+        case PATH_SINUSOIDAL: {
+            const int convex = (path == PATH_CONVEX);
+            const __m128 freq = _mm_set1_ps(convex ? PATH_PI : 4.0f * PATH_PI);
+            const __m128 amp = _mm_set1_ps(convex ? -200.0f : 100.0f);
+            for (; i + 4 <= count; i += 4) {
+                __m128 tv = _mm_loadu_ps(t + i);
+                __m128 s = FastSin4(_mm_mul_ps(tv, freq));
+                _mm_storeu_ps(x + i, _mm_mul_ps(tv, width));
+                _mm_storeu_ps(y + i, _mm_add_ps(mid, _mm_mul_ps(amp, s)));
+            }
+            if (convex) ConvexScalar(t + i, x + i, y + i, count - i);
+            else SinusoidalScalar(t + i, x + i, y + i, count - i);
+            break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 + FMA: 8 lanes
+// ---------------------------------------------------------------------------
+
+__attribute__((target("avx2,fma")))
+void CalculatePathBatchAVX2(int path, const float *t, float *x, float *y, int count) {
+    const __m256 width = _mm256_set1_ps((float)SCREEN_WIDTH);
+    const __m256 mid = _mm256_set1_ps(PATH_MID);
+    int i = 0;
+
+    switch (path) {
+        case PATH_STRAIGHT:
+            for (; i + 8 <= count; i += 8) {
+                _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(t + i), width));
+                _mm256_storeu_ps(y + i, mid);
+            }
+            StraightScalar(t + i, x + i, y + i, count - i);
+            break;
+
+        case PATH_ANGULAR: {
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256 low = _mm256_set1_ps(PATH_MID - 100.0f);
+            const __m256 high = _mm256_set1_ps(PATH_MID + 100.0f);
+            for (; i + 8 <= count; i += 8) {
+                __m256 tv = _mm256_loadu_ps(t + i);
+                __m256 upper = _mm256_cmp_ps(tv, half, _CMP_GE_OQ);
+                _mm256_storeu_ps(x + i, _mm256_mul_ps(tv, width));
+                _mm256_storeu_ps(y + i, _mm256_blendv_ps(low, high, upper));
+            }
+            AngularScalar(t + i, x + i, y + i, count - i);
+            break;
+        }
+
+        case PATH_CONVEX:
+        case PATH_SINUSOIDAL: {
+            const int convex = (path == PATH_CONVEX);
+            const __m256 freq = _mm256_set1_ps(convex ? PATH_PI : 4.0f * PATH_PI);
+            const __m256 amp = _mm256_set1_ps(convex ? -200.0f : 100.0f);
+            for (; i + 8 <= count; i += 8) {
+                __m256 tv = _mm256_loadu_ps(t + i);
+                __m256 s = FastSin8(_mm256_mul_ps(tv, freq));
+                _mm256_storeu_ps(x + i, _mm256_mul_ps(tv, width));
+                _mm256_storeu_ps(y + i, _mm256_fmadd_ps(amp, s, mid));
+            }
+            if (convex) ConvexScalar(t + i, x + i, y + i, count - i);
+            else SinusoidalScalar(t + i, x + i, y + i, count - i);
+            break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// AVX-512F: 16 lanes
+// ---------------------------------------------------------------------------
+
+__attribute__((target("avx512f")))
+void CalculatePathBatchAVX512(int path, const float *t, float *x, float *y, int count) {
+    const __m512 width = _mm512_set1_ps((float)SCREEN_WIDTH);
+    const __m512 mid = _mm512_set1_ps(PATH_MID);
+    int i = 0;
+
+    switch (path) {
+        case PATH_STRAIGHT:
+            for (; i + 16 <= count; i += 16) {
+                _mm512_storeu_ps(x + i, _mm512_mul_ps(_mm512_loadu_ps(t + i), width));
+                _mm512_storeu_ps(y + i, mid);
+            }
+            StraightScalar(t + i, x + i, y + i, count - i);
+            break;
+
+        case PATH_ANGULAR: {
+            const __m512 half = _mm512_set1_ps(0.5f);
+            const __m512 low = _mm512_set1_ps(PATH_MID - 100.0f);
+            const __m512 high = _mm512_set1_ps(PATH_MID + 100.0f);
+            for (; i + 16 <= count; i += 16) {
+                __m512 tv = _mm512_loadu_ps(t + i);
+                __mmask16 upper = _mm512_cmp_ps_mask(tv, half, _CMP_GE_OQ);
+                _mm512_storeu_ps(x + i, _mm512_mul_ps(tv, width));
+                _mm512_storeu_ps(y + i, _mm512_mask_blend_ps(upper, low, high));
+            }
+            AngularScalar(t + i, x + i, y + i, count - i);
+            break;
+        }
+
+        case PATH_CONVEX:
+        case PATH_SINUSOIDAL: {
+            const int convex = (path == PATH_CONVEX);
+            const __m512 freq = _mm512_set1_ps(convex ? PATH_PI : 4.0f * PATH_PI);
+            const __m512 amp = _mm512_set1_ps(convex ? -200.0f : 100.0f);
+            for (; i + 16 <= count; i += 16) {
+                __m512 tv = _mm512_loadu_ps(t + i);
+                __m512 s = FastSin16(_mm512_mul_ps(tv, freq));
+                _mm512_storeu_ps(x + i, _mm512_mul_ps(tv, width));
+                _mm512_storeu_ps(y + i, _mm512_fmadd_ps(amp, s, mid));
+            }
+            if (convex) ConvexScalar(t + i, x + i, y + i, count - i);
+            else SinusoidalScalar(t + i, x + i, y + i, count - i);
+            break;
+        }
+    }
+}
+
+#else // !PATH_BATCH_X86
+
+void CalculatePathBatchSSE(int path, const float *t, float *x, float *y, int count) {
+    CalculatePathBatchScalar(path, t, x, y, count);
+}
+
+void CalculatePathBatchAVX2(int path, const float *t, float *x, float *y, int count) {
+    CalculatePathBatchScalar(path, t, x, y, count);
+}
+
+void CalculatePathBatchAVX512(int path, const float *t, float *x, float *y, int count) {
+    CalculatePathBatchScalar(path, t, x, y, count);
+}
+
+#endif // PATH_BATCH_X86
+
+// Widest kernel the CPU supports (or the one BALLCORE_TIER forces)
+void CalculatePathBatch(int path, const float *t, float *x, float *y, int count) {
+    GetCpuDispatch()->pathBatch(path, t, x, y, count);
+}
+
+void CalculateStraightPathBatch(const float *t, float *x, float *y, int count) {
+    CalculatePathBatch(PATH_STRAIGHT, t, x, y, count);
+}
+
+void CalculateAngularPathBatch(const float *t, float *x, float *y, int count) {
+    CalculatePathBatch(PATH_ANGULAR, t, x, y, count);
+}
+
+void CalculateConvexPathBatch(const float *t, float *x, float *y, int count) {
+    CalculatePathBatch(PATH_CONVEX, t, x, y, count);
+}
+
+void CalculateSinusoidalPathBatch(const float *t, float *x, float *y, int count) {
+    CalculatePathBatch(PATH_SINUSOIDAL, t, x, y, count);
+}
@@ -0,0 +1,30 @@
+#ifndef PATH_BATCH_H
+#define PATH_BATCH_H
+
+// Batched (structure-of-arrays) path evaluation.
+//
+// Every kernel reads `count` values of t and writes the matching x and y
+// coordinates into two separate output arrays, so the vector kernels can
+// fill whole SSE/AVX registers instead of returning one Vector2 at a time.
+// The input and output arrays do not need any particular alignment.
+
+#include "paths.h"
+
+// Per-path entry points (use the widest kernel the CPU supports, see
+// cpuDispatch.h)
+void CalculateStraightPathBatch(const float *t, float *x, float *y, int count);
+void CalculateAngularPathBatch(const float *t, float *x, float *y, int count);
+void CalculateConvexPathBatch(const float *t, float *x, float *y, int count);
+void CalculateSinusoidalPathBatch(const float *t, float *x, float *y, int count);
+
+// Generic entry point: `path` is one of the PATH_* ids
+void CalculatePathBatch(int path, const float *t, float *x, float *y, int count);
+
+// Width-specific kernels: scalar, 4-wide SSE2, 8-wide AVX2, 16-wide AVX-512.
+// The caller must make sure the CPU supports the instruction set it picks.
+void CalculatePathBatchScalar(int path, const float *t, float *x, float *y, int count);
+void CalculatePathBatchSSE(int path, const float *t, float *x, float *y, int count);
+void CalculatePathBatchAVX2(int path, const float *t, float *x, float *y, int count);
+void CalculatePathBatchAVX512(int path, const float *t, float *x, float *y, int count);
+
+#endif // PATH_BATCH_H
@@ -0,0 +1,217 @@
+#include "pathExpr.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fastSin.h"
+#include "paths.h"
+
+const char *pathOpNames[PATH_OP_COUNT] = {"CONST", "LINEAR", "STEP", "SINE", "POLY3", "ADD", "MUL"};
+
+// Parameters each op takes; ADD and MUL take two expressions instead
+static const int opParams[PATH_OP_COUNT] = {1, 2, 3, 3, 4, 0, 0};
+
+typedef struct {
+    const char *at;
+    PathExpr *expr;
+    int depth;        // Stack depth after the ops emitted so far
+    int nesting;      // ADD / MUL calls open at the cursor
+} Parser;
+
+static void SkipSpace(Parser *parser) {
+    while (isspace((unsigned char)*parser->at)) parser->at++;
+}
+
+static bool Expect(Parser *parser, char c) {
+    SkipSpace(parser);
+    if (*parser->at != c) return false;
+    parser->at++;
+    return true;
+}
+
+// Identifier at the cursor into `name`; false when there is none or it is
+// too long to be one we know
+static bool ParseName(Parser *parser, char *name, size_t size) {
+    SkipSpace(parser);
+    size_t length = 0;
+    while (isalnum((unsigned char)parser->at[length]) || parser->at[length] == '_') length++;
+    if (length == 0 || length >= size) return false;
+    memcpy(name, parser->at, length);
+    name[length] = '\0';
+    parser->at += length;
+    return true;
+}
+
+static bool ParseFactor(Parser *parser, double *value) {
+    SkipSpace(parser);
+    double sign = 1.0;
+    if (*parser->at == '-' || *parser->at == '+') {
+        if (*parser->at == '-') sign = -1.0;
+        parser->at++;
+        SkipSpace(parser);
+    }
+
+    if (isdigit((unsigned char)*parser->at) || *parser->at == '.') {
+        char *end;
+        *value = sign * strtod(parser->at, &end);
+        if (end == parser->at) return false;
+        parser->at = end;
+        return true;
+    }
+
+    const char *start = parser->at;
+    char name[16];
+    if (!ParseName(parser, name, sizeof(name))) return false;
+    if (strcmp(name, "pi") == 0) *value = sign * 3.14159265358979323846;
+    else if (strcmp(name, "SCREEN_WIDTH") == 0) *value = sign * SCREEN_WIDTH;
+    else if (strcmp(name, "SCREEN_HEIGHT") == 0) *value = sign * SCREEN_HEIGHT;
+    else {
+        parser->at = start;
+        return false;
+    }
+    return true;
+}
+
+// factor (('*' | '/') factor)*, folded in double precision; the result
+// must be a finite float
+static bool ParseNumber(Parser *parser, float *value) {
+    double result;
+    if (!ParseFactor(parser, &result)) return false;
+    for (;;) {
+        SkipSpace(parser);
+        char op = *parser->at;
+        if (op != '*' && op != '/') break;
+        parser->at++;
+        double factor;
+        if (!ParseFactor(parser, &factor)) return false;
+        result = op == '*' ? result * factor : result / factor;
+    }
+    // 1/0 and constants past float range would run as inf or NaN
+    *value = (float)result;
+    return isfinite(*value);
+}
+
+static bool Emit(Parser *parser, PathExprOp op) {
+    PathExpr *expr = parser->expr;
+    if (expr->count == PATH_EXPR_MAX_OPS) return false;
+    parser->depth += (op.op == PATH_OP_ADD || op.op == PATH_OP_MUL) ? -1 : 1;
+    if (parser->depth > PATH_EXPR_MAX_DEPTH) return false;
+    if (parser->depth > expr->depth) expr->depth = parser->depth;
+    expr->ops[expr->count++] = op;
+    return true;
+}
+
+static bool ParseTerm(Parser *parser) {
+    const char *start = parser->at;
+    char name[16];
+    if (!ParseName(parser, name, sizeof(name))) return false;
+    int op = 0;
+    while (op < PATH_OP_COUNT && strcmp(name, pathOpNames[op]) != 0) op++;
+    if (op == PATH_OP_COUNT) {
+        parser->at = start;
+        return false;
+    }
+    if (!Expect(parser, '(')) return false;
+
+    PathExprOp emitted = {op, {0.0f, 0.0f, 0.0f, 0.0f}};
+    if (op == PATH_OP_ADD || op == PATH_OP_MUL) {
+        // Every ADD / MUL is an op of its own, so nesting deeper than the op
+        // limit can never fit; stop there instead of recursing on and on
+        if (++parser->nesting > PATH_EXPR_MAX_OPS) return false;
+        if (!ParseTerm(parser) || !Expect(parser, ',') || !ParseTerm(parser)) return false;
+        parser->nesting--;
+    } else {
+        for (int i = 0; i < opParams[op]; i++) {
+            if (i > 0 && !Expect(parser, ',')) return false;
+            if (!ParseNumber(parser, &emitted.p[i])) return false;
+        }
+    }
+    if (!Expect(parser, ')')) return false;
+    return Emit(parser, emitted);
+}
+
+bool PathExprParse(PathExpr *expr, const char *text, int *errorOffset) {
+    memset(expr, 0, sizeof(*expr));
+    Parser parser = {text, expr, 0, 0};
+    bool ok = ParseTerm(&parser);
+    if (ok) {
+        SkipSpace(&parser);
+        ok = *parser.at == '\0';
+    }
+    if (!ok && errorOffset != NULL) *errorOffset = (int)(parser.at - text);
+    return ok;
+}
+
+float PathExprEval(const PathExpr *expr, float t) {
+    float stack[PATH_EXPR_MAX_DEPTH];
+    int top = 0;
+    for (int i = 0; i < expr->count; i++) {
+        const float *p = expr->ops[i].p;
+        switch (expr->ops[i].op) {
+            case PATH_OP_CONST: stack[top++] = p[0]; break;
+            case PATH_OP_LINEAR: stack[top++] = p[0] * t + p[1]; break;
+            case PATH_OP_STEP: stack[top++] = t < p[0] ? p[1] : p[2]; break;
+            case PATH_OP_SINE: stack[top++] = p[0] * FastSinf(p[1] * t + p[2]); break;
+            case PATH_OP_POLY3: stack[top++] = ((p[3] * t + p[2]) * t + p[1]) * t + p[0]; break;
+            case PATH_OP_ADD: top--; stack[top - 1] += stack[top]; break;
+            case PATH_OP_MUL: top--; stack[top - 1] *= stack[top]; break;
+        }
+    }
+    return top > 0 ? stack[0] : 0.0f;
+}
+
+// One block of PATH_EXPR_BLOCK values: every op runs over the whole block
+// before the next is decoded, and the fixed trip count lets the compiler
+// vectorize the loops
+static void EvalBlock(const PathExpr *expr, const float *t, float *out) {
+    float stack[PATH_EXPR_MAX_DEPTH][PATH_EXPR_BLOCK];
+    int top = 0;
+    for (int i = 0; i < expr->count; i++) {
+        // Parameters in locals, so the selects below need no loads
+        const float p0 = expr->ops[i].p[0], p1 = expr->ops[i].p[1];
+        const float p2 = expr->ops[i].p[2], p3 = expr->ops[i].p[3];
+        float *v = stack[top];
+        switch (expr->ops[i].op) {
+            case PATH_OP_CONST:
+                for (int j = 0; j < PATH_EXPR_BLOCK; j++) v[j] = p0;
+                break;
+            case PATH_OP_LINEAR:
+                for (int j = 0; j < PATH_EXPR_BLOCK; j++) v[j] = p0 * t[j] + p1;
+                break;
+            case PATH_OP_STEP:
+                for (int j = 0; j < PATH_EXPR_BLOCK; j++) v[j] = t[j] < p0 ? p1 : p2;
+                break;
+            case PATH_OP_SINE:
+                for (int j = 0; j < PATH_EXPR_BLOCK; j++) v[j] = p0 * FastSinf(p1 * t[j] + p2);
+                break;
+            case PATH_OP_POLY3:
+                for (int j = 0; j < PATH_EXPR_BLOCK; j++) v[j] = ((p3 * t[j] + p2) * t[j] + p1) * t[j] + p0;
+                break;
+            case PATH_OP_ADD:
+                top -= 2;
+                for (int j = 0; j < PATH_EXPR_BLOCK; j++) stack[top][j] += stack[top + 1][j];
+                break;
+            case PATH_OP_MUL:
+                top -= 2;
+                for (int j = 0; j < PATH_EXPR_BLOCK; j++) stack[top][j] *= stack[top + 1][j];
+                break;
+        }
+        top++;
+    }
+    if (top > 0) memcpy(out, stack[0], sizeof(stack[0]));
+    else memset(out, 0, sizeof(stack[0]));
+}
+
+void PathExprEvalBatch(const PathExpr *expr, const float *t, float *out, int count) {
+    int i = 0;
+    for (; i + PATH_EXPR_BLOCK <= count; i += PATH_EXPR_BLOCK) {
+        EvalBlock(expr, t + i, out + i);
+    }
+    if (i < count) {
+        // The tail runs as one padded block
+        float tailT[PATH_EXPR_BLOCK] = {0}, tailOut[PATH_EXPR_BLOCK];
+        memcpy(tailT, t + i, sizeof(float) * (size_t)(count - i));
+        EvalBlock(expr, tailT, tailOut);
+        memcpy(out + i, tailOut, sizeof(float) * (size_t)(count - i));
+    }
+}
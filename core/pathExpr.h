@@ -0,0 +1,57 @@
+#ifndef PATH_EXPR_H
+#define PATH_EXPR_H
+
+#include <stdbool.h>
+
+// Path expressions parsed at run time.
+//
+// The text uses the vocabulary of pathSpecs.def, one expression in t per
+// coordinate:
+//   ADD(CONST(SCREEN_HEIGHT / 2), MUL(LINEAR(-150, 150), SINE(1, 6 * pi, 0)))
+// Parameters are numbers, `pi`, SCREEN_WIDTH or SCREEN_HEIGHT, optionally
+// joined by * and /, and must fold to a finite float. The parsed form is a
+// postfix program: the terms push a value, ADD and MUL pop two and push one.
+//
+// PathExprEval and PathExprEvalBatch interpret the program; pathJit.h
+// compiles it to machine code. The interpreter handles PATH_EXPR_BLOCK
+// values of t per op so the dispatch is paid once per block, not per ball.
+
+#define PATH_EXPR_MAX_OPS 64     // Terms plus ADD/MUL nodes in one expression
+#define PATH_EXPR_MAX_DEPTH 16   // Values on the stack at once
+#define PATH_EXPR_BLOCK 64       // t values per interpreter pass
+
+// Ops; the terms take the parameters in pathSpec.h order
+#define PATH_OP_CONST 0    // c
+#define PATH_OP_LINEAR 1   // a, b
+#define PATH_OP_STEP 2     // edge, low, high
+#define PATH_OP_SINE 3     // amp, freq, phase
+#define PATH_OP_POLY3 4    // c0, c1, c2, c3
+#define PATH_OP_ADD 5
+#define PATH_OP_MUL 6
+#define PATH_OP_COUNT 7
+
+typedef struct {
+    int op;           // PATH_OP_*
+    float p[4];       // Parameters, unused ones zero
+} PathExprOp;
+
+typedef struct {
+    int count;        // Ops in the program
+    int depth;        // Deepest the stack gets
+    PathExprOp ops[PATH_EXPR_MAX_OPS];
+} PathExpr;
+
+// Upper-case op names as written in expressions
+extern const char *pathOpNames[PATH_OP_COUNT];
+
+// Parse `text` into `expr`. On failure returns false and, when errorOffset
+// is not NULL, stores the byte offset where parsing stopped.
+bool PathExprParse(PathExpr *expr, const char *text, int *errorOffset);
+
+// Value of the expression at t
+float PathExprEval(const PathExpr *expr, float t);
+
+// PathExprEval for `count` values of t
+void PathExprEvalBatch(const PathExpr *expr, const float *t, float *out, int count);
+
+#endif // PATH_EXPR_H
@@ -0,0 +1,355 @@
+#include "pathFixed.h"
+#include <pthread.h>
+#include "cpuDispatch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PATH_FIXED_X86 1
+#endif
+
+#define FIXED_MID FixedFromInt(SCREEN_HEIGHT / 2)
+
+// Table entries: start value << SINE_RISE_BITS | rise to the next entry.
+// The rise is at most 402 (2 pi / 1024 in Q16.16), so 11 signed bits hold
+// it and 21 are left for a start value in [-FIXED_ONE, FIXED_ONE].
+#define SINE_RISE_BITS 11
+#define SINE_FRACTION_BITS 15
+#define SINE_FRACTION_SHIFT (32 - FIXED_SINE_BITS - SINE_FRACTION_BITS)
+#define SINE_FRACTION_MASK ((1 << SINE_FRACTION_BITS) - 1)
+#define SINE_ROUND (1 << (SINE_FRACTION_BITS - 1))
+
+// Phase shifts from t in Q16.16 to a 2^32-per-turn angle: sin(pi * t) and
+// sin(4 * pi * t)
+#define CONVEX_PHASE_SHIFT 15
+#define SINUSOIDAL_PHASE_SHIFT 17
+
+// round(sin(2 pi i / FIXED_SINE_SIZE) * FIXED_ONE) for the first quarter
+// turn, i = 0 .. FIXED_SINE_SIZE / 4. Written out rather than computed with
+// sin() so no libm can change a bit of it.
+static const int sineQuarter[FIXED_SINE_SIZE / 4 + 1] = {
+    0, 402, 804, 1206, 1608, 2010, 2412, 2814, 3216, 3617, 4019, 4420,
+    4821, 5222, 5623, 6023, 6424, 6824, 7224, 7623, 8022, 8421, 8820, 9218,
+    9616, 10014, 10411, 10808, 11204, 11600, 11996, 12391, 12785, 13180, 13573, 13966,
+    14359, 14751, 15143, 15534, 15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639,
+    19024, 19409, 19792, 20175, 20557, 20939, 21320, 21699, 22078, 22457, 22834, 23210,
+    23586, 23961, 24335, 24708, 25080, 25451, 25821, 26190, 26558, 26925, 27291, 27656,
+    28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538, 30893, 31248, 31600, 31952,
+    32303, 32652, 33000, 33347, 33692, 34037, 34380, 34721, 35062, 35401, 35738, 36075,
+    36410, 36744, 37076, 37407, 37736, 38064, 38391, 38716, 39040, 39362, 39683, 40002,
+    40320, 40636, 40951, 41264, 41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+    44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056, 46341, 46624, 46906, 47186,
+    47464, 47741, 48015, 48288, 48559, 48828, 49095, 49361, 49624, 49886, 50146, 50404,
+    50660, 50914, 51166, 51417, 51665, 51911, 52156, 52398, 52639, 52878, 53114, 53349,
+    53581, 53812, 54040, 54267, 54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004,
+    56212, 56418, 56621, 56823, 57022, 57219, 57414, 57607, 57798, 57986, 58172, 58356,
+    58538, 58718, 58896, 59071, 59244, 59415, 59583, 59750, 59914, 60075, 60235, 60392,
+    60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568, 61705, 61839, 61971, 62101,
+    62228, 62353, 62476, 62596, 62714, 62830, 62943, 63054, 63162, 63268, 63372, 63473,
+    63572, 63668, 63763, 63854, 63944, 64031, 64115, 64197, 64277, 64354, 64429, 64501,
+    64571, 64639, 64704, 64766, 64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+    65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436, 65457, 65476, 65492, 65505,
+    65516, 65525, 65531, 65535, 65536,
+};
+
+static int sineTable[FIXED_SINE_SIZE];
+static pthread_once_t sineOnce = PTHREAD_ONCE_INIT;
+
+// The other three quarters by symmetry, then start values and rises packed
+static void BuildSineTable(void) {
+    int values[FIXED_SINE_SIZE + 1];
+    for (int i = 0; i <= FIXED_SINE_SIZE / 2; i++) {
+        values[i] = sineQuarter[i <= FIXED_SINE_SIZE / 4 ? i : FIXED_SINE_SIZE / 2 - i];
+    }
+    for (int i = FIXED_SINE_SIZE / 2 + 1; i <= FIXED_SINE_SIZE; i++) {
+        values[i] = -values[i - FIXED_SINE_SIZE / 2];
+    }
+    for (int i = 0; i < FIXED_SINE_SIZE; i++) {
+        int rise = values[i + 1] - values[i];
+        sineTable[i] = (int)(((unsigned)values[i] << SINE_RISE_BITS) | ((unsigned)rise & ((1u << SINE_RISE_BITS) - 1)));
+    }
+}
+
+static const int *SineTable(void) {
+    pthread_once(&sineOnce, BuildSineTable);
+    return sineTable;
+}
+
+// Right shifts of negative values are arithmetic on every compiler this
+// builds with, and the vector kernels use the same psrad
+static inline Fixed SineLookup(const int *table, unsigned phase) {
+    int entry = table[phase >> (32 - FIXED_SINE_BITS)];
+    int start = entry >> SINE_RISE_BITS;
+    int rise = (int)((unsigned)entry << (32 - SINE_RISE_BITS)) >> (32 - SINE_RISE_BITS);
+    int fraction = (int)((phase >> SINE_FRACTION_SHIFT) & SINE_FRACTION_MASK);
+    return start + ((rise * fraction + SINE_ROUND) >> SINE_FRACTION_BITS);
+}
+
+Fixed FixedSin(unsigned phase) {
+    return SineLookup(SineTable(), phase);
+}
+
+// x wraps like the vector multiplies instead of overflowing
+static inline Fixed FixedX(Fixed t) {
+    return (Fixed)((unsigned)t * SCREEN_WIDTH);
+}
+
+void PathFixedPoint(int path, Fixed t, Fixed *x, Fixed *y) {
+    *x = FixedX(t);
+    switch (path) {
+        case PATH_STRAIGHT: *y = FIXED_MID; break;
+        case PATH_ANGULAR: *y = FIXED_MID + FixedFromInt(t < FIXED_ONE / 2 ? -100 : 100); break;
+        case PATH_CONVEX: *y = FIXED_MID - 200 * FixedSin((unsigned)t << CONVEX_PHASE_SHIFT); break;
+        case PATH_SINUSOIDAL: *y = FIXED_MID + 100 * FixedSin((unsigned)t << SINUSOIDAL_PHASE_SHIFT); break;
+        default: *y = FIXED_MID; break;
+    }
+}
+
+// Scalar kernel, also used for the tails of the vector kernels
+void PathFixedBatchScalar(int path, const Fixed *t, Fixed *x, Fixed *y, int count) {
+    const int *table = SineTable();
+    switch (path) {
+        case PATH_STRAIGHT:
+            for (int i = 0; i < count; i++) {
+                x[i] = FixedX(t[i]);
+                y[i] = FIXED_MID;
+            }
+            break;
+        case PATH_ANGULAR:
+            for (int i = 0; i < count; i++) {
+                x[i] = FixedX(t[i]);
+                y[i] = FIXED_MID + FixedFromInt(t[i] < FIXED_ONE / 2 ? -100 : 100);
+            }
+            break;
+        case PATH_CONVEX:
+        case PATH_SINUSOIDAL: {
+            const int convex = (path == PATH_CONVEX);
+            const int shift = convex ? CONVEX_PHASE_SHIFT : SINUSOIDAL_PHASE_SHIFT;
+            const int amp = convex ? -200 : 100;
+            for (int i = 0; i < count; i++) {
+                x[i] = FixedX(t[i]);
+                y[i] = FIXED_MID + amp * SineLookup(table, (unsigned)t[i] << shift);
+            }
+            break;
+        }
+    }
+}
+
+#ifdef PATH_FIXED_X86
+
+// ---------------------------------------------------------------------------
+// SSE2: 4 lanes
+// ---------------------------------------------------------------------------
+
+// SSE2 has no 32-bit mullo (pmulld is SSE4.1): two pmuludq on the even and
+// odd lanes, whose low halves are the same bits for signed operands
+__attribute__((target("sse2")))
+static inline __m128i MulLo4(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// No gather either, so the four entries are loaded one by one. The rise
+// times the fraction is one pmaddwd: both fit in 16 bits, and the fraction's
+// upper half is zero, so the rise's sign bits up there add nothing.
+__attribute__((target("sse2")))
+static inline __m128i SineLookup4(const int *table, __m128i phase) {
+    int index[4];
+    _mm_storeu_si128((__m128i *)index, _mm_srli_epi32(phase, 32 - FIXED_SINE_BITS));
+    __m128i entry = _mm_setr_epi32(table[index[0]], table[index[1]], table[index[2]], table[index[3]]);
+    __m128i start = _mm_srai_epi32(entry, SINE_RISE_BITS);
+    __m128i rise = _mm_srai_epi32(_mm_slli_epi32(entry, 32 - SINE_RISE_BITS), 32 - SINE_RISE_BITS);
+    __m128i fraction = _mm_and_si128(_mm_srli_epi32(phase, SINE_FRACTION_SHIFT), _mm_set1_epi32(SINE_FRACTION_MASK));
+    __m128i product = _mm_add_epi32(_mm_madd_epi16(rise, fraction), _mm_set1_epi32(SINE_ROUND));
+    return _mm_add_epi32(start, _mm_srai_epi32(product, SINE_FRACTION_BITS));
+}
+
+__attribute__((target("sse2")))
+void PathFixedBatchSSE(int path, const Fixed *t, Fixed *x, Fixed *y, int count) {
+    const __m128i width = _mm_set1_epi32(SCREEN_WIDTH);
+    const __m128i mid = _mm_set1_epi32(FIXED_MID);
+    int i = 0;
+
+    switch (path) {
+        case PATH_STRAIGHT:
+            for (; i + 4 <= count; i += 4) {
+                _mm_storeu_si128((__m128i *)(x + i), MulLo4(_mm_loadu_si128((const __m128i *)(t + i)), width));
+                _mm_storeu_si128((__m128i *)(y + i), mid);
+            }
+            break;
+
+        case PATH_ANGULAR: {
+            const __m128i half = _mm_set1_epi32(FIXED_ONE / 2);
+            const __m128i low = _mm_set1_epi32(FIXED_MID - FixedFromInt(100));
+            const __m128i step = _mm_set1_epi32(FixedFromInt(200));
+            for (; i + 4 <= count; i += 4) {
+                __m128i tv = _mm_loadu_si128((const __m128i *)(t + i));
+                __m128i lower = _mm_cmplt_epi32(tv, half);
+                _mm_storeu_si128((__m128i *)(x + i), MulLo4(tv, width));
+                _mm_storeu_si128((__m128i *)(y + i), _mm_add_epi32(low, _mm_andnot_si128(lower, step)));
+            }
+            break;
+        }
+
+        case PATH_CONVEX:
+        case PATH_SINUSOIDAL: {
+            const int *table = SineTable();
+            const int convex = (path == PATH_CONVEX);
+            const int shift = convex ? CONVEX_PHASE_SHIFT : SINUSOIDAL_PHASE_SHIFT;
+            const __m128i amp = _mm_set1_epi32(convex ? -200 : 100);
+            for (; i + 4 <= count; i += 4) {
+                __m128i tv = _mm_loadu_si128((const __m128i *)(t + i));
+                __m128i s = SineLookup4(table, _mm_slli_epi32(tv, shift));
+                _mm_storeu_si128((__m128i *)(x + i), MulLo4(tv, width));
+                _mm_storeu_si128((__m128i *)(y + i), _mm_add_epi32(mid, MulLo4(amp, s)));
+            }
+            break;
+        }
+    }
+    PathFixedBatchScalar(path, t + i, x + i, y + i, count - i);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2: 8 lanes
+// ---------------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+static inline __m256i SineLookup8(const int *table, __m256i phase) {
+    __m256i entry = _mm256_i32gather_epi32(table, _mm256_srli_epi32(phase, 32 - FIXED_SINE_BITS), 4);
+    __m256i start = _mm256_srai_epi32(entry, SINE_RISE_BITS);
+    __m256i rise = _mm256_srai_epi32(_mm256_slli_epi32(entry, 32 - SINE_RISE_BITS), 32 - SINE_RISE_BITS);
+    __m256i fraction = _mm256_and_si256(_mm256_srli_epi32(phase, SINE_FRACTION_SHIFT),
+                                        _mm256_set1_epi32(SINE_FRACTION_MASK));
+    __m256i product = _mm256_add_epi32(_mm256_mullo_epi32(rise, fraction), _mm256_set1_epi32(SINE_ROUND));
+    return _mm256_add_epi32(start, _mm256_srai_epi32(product, SINE_FRACTION_BITS));
+}
+
+__attribute__((target("avx2")))
+void PathFixedBatchAVX2(int path, const Fixed *t, Fixed *x, Fixed *y, int count) {
+    const __m256i width = _mm256_set1_epi32(SCREEN_WIDTH);
+    const __m256i mid = _mm256_set1_epi32(FIXED_MID);
+    int i = 0;
+
+    switch (path) {
+        case PATH_STRAIGHT:
+            for (; i + 8 <= count; i += 8) {
+                __m256i tv = _mm256_loadu_si256((const __m256i *)(t + i));
+                _mm256_storeu_si256((__m256i *)(x + i), _mm256_mullo_epi32(tv, width));
+                _mm256_storeu_si256((__m256i *)(y + i), mid);
+            }
+            break;
+
+        case PATH_ANGULAR: {
+            // cmpgt against half - 1 is t >= half
+            const __m256i below = _mm256_set1_epi32(FIXED_ONE / 2 - 1);
+            const __m256i low = _mm256_set1_epi32(FIXED_MID - FixedFromInt(100));
+            const __m256i step = _mm256_set1_epi32(FixedFromInt(200));
+            for (; i + 8 <= count; i += 8) {
+                __m256i tv = _mm256_loadu_si256((const __m256i *)(t + i));
+                __m256i upper = _mm256_cmpgt_epi32(tv, below);
+                _mm256_storeu_si256((__m256i *)(x + i), _mm256_mullo_epi32(tv, width));
+                _mm256_storeu_si256((__m256i *)(y + i), _mm256_add_epi32(low, _mm256_and_si256(upper, step)));
+            }
+            break;
+        }
+
+        case PATH_CONVEX:
+        case PATH_SINUSOIDAL: {
+            const int *table = SineTable();
+            const int convex = (path == PATH_CONVEX);
+            const __m128i shift = _mm_cvtsi32_si128(convex ? CONVEX_PHASE_SHIFT : SINUSOIDAL_PHASE_SHIFT);
+            const __m256i amp = _mm256_set1_epi32(convex ? -200 : 100);
+            for (; i + 8 <= count; i += 8) {
+                __m256i tv = _mm256_loadu_si256((const __m256i *)(t + i));
+                __m256i s = SineLookup8(table, _mm256_sll_epi32(tv, shift));
+                _mm256_storeu_si256((__m256i *)(x + i), _mm256_mullo_epi32(tv, width));
+                _mm256_storeu_si256((__m256i *)(y + i), _mm256_add_epi32(mid, _mm256_mullo_epi32(amp, s)));
+            }
+            break;
+        }
+    }
+    PathFixedBatchScalar(path, t + i, x + i, y + i, count - i);
+}
+
+// ---------------------------------------------------------------------------
+// AVX-512F: 16 lanes
+// ---------------------------------------------------------------------------
+
+__attribute__((target("avx512f")))
+static inline __m512i SineLookup16(const int *table, __m512i phase) {
+    __m512i entry = _mm512_i32gather_epi32(_mm512_srli_epi32(phase, 32 - FIXED_SINE_BITS), table, 4);
+    __m512i start = _mm512_srai_epi32(entry, SINE_RISE_BITS);
+    __m512i rise = _mm512_srai_epi32(_mm512_slli_epi32(entry, 32 - SINE_RISE_BITS), 32 - SINE_RISE_BITS);
+    __m512i fraction = _mm512_and_si512(_mm512_srli_epi32(phase, SINE_FRACTION_SHIFT),
+                                        _mm512_set1_epi32(SINE_FRACTION_MASK));
+    __m512i product = _mm512_add_epi32(_mm512_mullo_epi32(rise, fraction), _mm512_set1_epi32(SINE_ROUND));
+    return _mm512_add_epi32(start, _mm512_srai_epi32(product, SINE_FRACTION_BITS));
+}
+
+__attribute__((target("avx512f")))
+void PathFixedBatchAVX512(int path, const Fixed *t, Fixed *x, Fixed *y, int count) {
+    const __m512i width = _mm512_set1_epi32(SCREEN_WIDTH);
+    const __m512i mid = _mm512_set1_epi32(FIXED_MID);
+    int i = 0;
+
+    switch (path) {
+        case PATH_STRAIGHT:
+            for (; i + 16 <= count; i += 16) {
+                __m512i tv = _mm512_loadu_si512(t + i);
+                _mm512_storeu_si512(x + i, _mm512_mullo_epi32(tv, width));
+                _mm512_storeu_si512(y + i, mid);
+            }
+            break;
+
+        case PATH_ANGULAR: {
+            const __m512i half = _mm512_set1_epi32(FIXED_ONE / 2);
+            const __m512i low = _mm512_set1_epi32(FIXED_MID - FixedFromInt(100));
+            const __m512i high = _mm512_set1_epi32(FIXED_MID + FixedFromInt(100));
+            for (; i + 16 <= count; i += 16) {
+                __m512i tv = _mm512_loadu_si512(t + i);
+                __mmask16 lower = _mm512_cmplt_epi32_mask(tv, half);
+                _mm512_storeu_si512(x + i, _mm512_mullo_epi32(tv, width));
+                _mm512_storeu_si512(y + i, _mm512_mask_blend_epi32(lower, high, low));
+            }
+            break;
+        }
+
+        case PATH_CONVEX:
+        case PATH_SINUSOIDAL: {
+            const int *table = SineTable();
+            const int convex = (path == PATH_CONVEX);
+            const __m128i shift = _mm_cvtsi32_si128(convex ? CONVEX_PHASE_SHIFT : SINUSOIDAL_PHASE_SHIFT);
+            const __m512i amp = _mm512_set1_epi32(convex ? -200 : 100);
+            for (; i + 16 <= count; i += 16) {
+                __m512i tv = _mm512_loadu_si512(t + i);
+                __m512i s = SineLookup16(table, _mm512_sll_epi32(tv, shift));
+                _mm512_storeu_si512(x + i, _mm512_mullo_epi32(tv, width));
+                _mm512_storeu_si512(y + i, _mm512_add_epi32(mid, _mm512_mullo_epi32(amp, s)));
+            }
+            break;
+        }
+    }
+    PathFixedBatchScalar(path, t + i, x + i, y + i, count - i);
+}
+
+#else // !PATH_FIXED_X86
+
+void PathFixedBatchSSE(int path, const Fixed *t, Fixed *x, Fixed *y, int count) {
+    PathFixedBatchScalar(path, t, x, y, count);
+}
+
+void PathFixedBatchAVX2(int path, const Fixed *t, Fixed *x, Fixed *y, int count) {
+    PathFixedBatchScalar(path, t, x, y, count);
+}
+
+void PathFixedBatchAVX512(int path, const Fixed *t, Fixed *x, Fixed *y, int count) {
+    PathFixedBatchScalar(path, t, x, y, count);
+}
+
+#endif // PATH_FIXED_X86
+
+// Widest kernel the CPU supports (or the one BALLCORE_TIER forces)
+void PathFixedBatch(int path, const Fixed *t, Fixed *x, Fixed *y, int count) {
+    GetCpuDispatch()->pathFixedBatch(path, t, x, y, count);
+}
@@ -0,0 +1,373 @@
+#include "pathJit.h"
+#include <stdlib.h>
+#include <string.h>
+#include "cpuDispatch.h"
+#include "fastSin.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define PATH_JIT_X86_64 1
+#endif
+
+#ifdef PATH_JIT_X86_64
+
+#define JIT_CODE_MAX 32768
+#define JIT_CONSTANT_MAX 1024
+#define JIT_FIXUP_MAX 4096
+
+// Register plan: t, the value stack, and the sine's scratch registers
+#define REG_T 0
+#define REG_STACK 1
+#define REG_STACK_COUNT 11
+#define REG_K 12    // Sine: k, then its sign bit
+#define REG_KF 13   // Sine: k as a float, then the range mask
+#define REG_S 14    // Sine: r * r, then r * r * r
+#define REG_U 15    // Sine: polynomial
+
+// ModRM operand kinds
+#define RM_REG 0    // ymm register
+#define RM_CONST 1  // Broadcast constant, RIP-relative
+#define RM_MEM 2    // [base + rax]
+
+// Opcode maps and prefixes of the VEX forms used
+#define MAP_0F 1
+#define MAP_0F38 2
+#define MAP_0F3A 3
+#define PP_NONE 0
+#define PP_66 1
+
+#define CMP_LT_OQ 0x11
+#define CMP_NLE_UQ 0x06
+
+typedef struct {
+    int at;           // Offset of the disp32
+    int constant;     // Index into constants
+    int trailing;     // Instruction bytes after the disp32 (an imm8)
+} Fixup;
+
+typedef struct {
+    unsigned char code[JIT_CODE_MAX];
+    int size;
+    unsigned int constants[JIT_CONSTANT_MAX];  // Bit patterns, 8 copies each in the page
+    int constantCount;
+    Fixup fixups[JIT_FIXUP_MAX];
+    int fixupCount;
+    bool overflow;
+
+    // Constants the loop reads most, held in the registers the value stack
+    // leaves free; a constant operand becomes a register operand once pinned
+    int uses[JIT_CONSTANT_MAX];
+    int pinned[JIT_CONSTANT_MAX];  // Register + 1, 0 when read from memory
+    bool usePins;
+} Assembler;
+
+static void Byte(Assembler *a, unsigned int value) {
+    if (a->size == JIT_CODE_MAX) {
+        a->overflow = true;
+        return;
+    }
+    a->code[a->size++] = (unsigned char)value;
+}
+
+static void Dword(Assembler *a, unsigned int value) {
+    for (int i = 0; i < 4; i++) Byte(a, (value >> (8 * i)) & 0xff);
+}
+
+static int ConstantBits(Assembler *a, unsigned int bits) {
+    for (int i = 0; i < a->constantCount; i++) {
+        if (a->constants[i] == bits) return i;
+    }
+    if (a->constantCount == JIT_CONSTANT_MAX) {
+        a->overflow = true;
+        return 0;
+    }
+    a->constants[a->constantCount] = bits;
+    return a->constantCount++;
+}
+
+static int Constant(Assembler *a, float value) {
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return ConstantBits(a, bits);
+}
+
+// One 256-bit VEX instruction (W0): opcode, ModRM reg, the extra source in
+// VEX.vvvv (0 when unused) and the r/m operand. `trailing` counts the bytes
+// the caller appends after it, which RIP-relative addressing must skip.
+static void Vex(Assembler *a, int map, int pp, int opcode, int reg, int vvvv, int rmKind, int rm, int trailing) {
+    if (rmKind == RM_CONST) {
+        a->uses[rm]++;
+        if (a->usePins && a->pinned[rm] != 0) {
+            rmKind = RM_REG;
+            rm = a->pinned[rm] - 1;
+        }
+    }
+    int r = reg >> 3;
+    int b = rmKind == RM_CONST ? 0 : rm >> 3;
+    int tail = ((~vvvv & 15) << 3) | 4 | pp;  // vvvv inverted, L = 256
+    if (map == MAP_0F && !b) {
+        Byte(a, 0xc5);
+        Byte(a, (unsigned)(!r << 7) | tail);
+    } else {
+        Byte(a, 0xc4);
+        Byte(a, (unsigned)(!r << 7) | (1 << 6) | (!b << 5) | map);
+        Byte(a, tail);
+    }
+    Byte(a, opcode);
+
+    switch (rmKind) {
+        case RM_REG:
+            Byte(a, 0xc0 | (reg & 7) << 3 | (rm & 7));
+            break;
+        case RM_CONST:
+            Byte(a, 0x05 | (reg & 7) << 3);
+            if (a->fixupCount == JIT_FIXUP_MAX) {
+                a->overflow = true;
+            } else {
+                a->fixups[a->fixupCount++] = (Fixup){a->size, rm, trailing};
+            }
+            Dword(a, 0);
+            break;
+        case RM_MEM:
+            Byte(a, 0x04 | (reg & 7) << 3);
+            Byte(a, (0 << 3) | (rm & 7));  // SIB: index rax, scale 1
+            break;
+    }
+}
+
+static void LoadConstant(Assembler *a, int dst, float value) {
+    Vex(a, MAP_0F, PP_NONE, 0x10, dst, 0, RM_CONST, Constant(a, value), 0);  // vmovups
+}
+
+// dst = t * dst + value
+static void FmaT(Assembler *a, int dst, float value) {
+    Vex(a, MAP_0F38, PP_66, 0xa8, dst, REG_T, RM_CONST, Constant(a, value), 0);  // vfmadd213ps
+}
+
+// dst = FastSin8(dst)
+static void EmitSine(Assembler *a, int d) {
+    // k = round(x / pi), r = x - k * pi in four parts
+    Vex(a, MAP_0F, PP_NONE, 0x59, REG_K, d, RM_CONST, Constant(a, FAST_SIN_INV_PI), 0);  // vmulps
+    Vex(a, MAP_0F, PP_66, 0x5b, REG_K, 0, RM_REG, REG_K, 0);                             // vcvtps2dq
+    Vex(a, MAP_0F, PP_NONE, 0x5b, REG_KF, 0, RM_REG, REG_K, 0);                          // vcvtdq2ps
+    const float pi[4] = {FAST_SIN_PI_A, FAST_SIN_PI_B, FAST_SIN_PI_C, FAST_SIN_PI_D};
+    for (int i = 0; i < 4; i++) {
+        Vex(a, MAP_0F38, PP_66, 0xbc, d, REG_KF, RM_CONST, Constant(a, pi[i]), 0);       // vfnmadd231ps
+    }
+
+    // Odd polynomial in r
+    Vex(a, MAP_0F, PP_NONE, 0x59, REG_S, d, RM_REG, d, 0);                               // vmulps
+    LoadConstant(a, REG_U, FAST_SIN_C4);
+    const float c[3] = {FAST_SIN_C3, FAST_SIN_C2, FAST_SIN_C1};
+    for (int i = 0; i < 3; i++) {
+        Vex(a, MAP_0F38, PP_66, 0xa8, REG_U, REG_S, RM_CONST, Constant(a, c[i]), 0);     // vfmadd213ps
+    }
+    Vex(a, MAP_0F, PP_NONE, 0x59, REG_S, REG_S, RM_REG, d, 0);                           // vmulps
+    Vex(a, MAP_0F38, PP_66, 0xa8, REG_S, REG_U, RM_REG, d, 0);                           // vfmadd213ps
+
+    // Bit 0 of k into the sign
+    Vex(a, MAP_0F, PP_66, 0xdb, REG_K, REG_K, RM_CONST, ConstantBits(a, 1), 0);          // vpand
+    Vex(a, MAP_0F, PP_66, 0x72, 6, REG_K, RM_REG, REG_K, 1);                             // vpslld
+    Byte(a, 31);
+    Vex(a, MAP_0F, PP_NONE, 0x57, d, REG_S, RM_REG, REG_K, 0);                           // vxorps
+
+    // NaN (all bits set) where |k| is past the range
+    Vex(a, MAP_0F, PP_NONE, 0x54, REG_KF, REG_KF, RM_CONST, ConstantBits(a, 0x7fffffff), 0);  // vandps
+    Vex(a, MAP_0F, PP_NONE, 0xc2, REG_KF, REG_KF, RM_CONST, Constant(a, FAST_SIN_K_MAX), 1);  // vcmpps
+    Byte(a, CMP_NLE_UQ);
+    Vex(a, MAP_0F, PP_NONE, 0x56, d, d, RM_REG, REG_KF, 0);                              // vorps
+}
+
+// Code for one program, leaving its value in REG_STACK
+static void EmitProgram(Assembler *a, const PathExpr *expr) {
+    int top = 0;
+    for (int i = 0; i < expr->count; i++) {
+        const PathExprOp *op = &expr->ops[i];
+        int d = REG_STACK + top;
+        switch (op->op) {
+            case PATH_OP_CONST:
+                LoadConstant(a, d, op->p[0]);
+                break;
+            case PATH_OP_LINEAR:
+                LoadConstant(a, d, op->p[0]);
+                FmaT(a, d, op->p[1]);
+                break;
+            case PATH_OP_STEP:
+                Vex(a, MAP_0F, PP_NONE, 0xc2, REG_K, REG_T, RM_CONST, Constant(a, op->p[0]), 1);  // vcmpps
+                Byte(a, CMP_LT_OQ);
+                LoadConstant(a, d, op->p[2]);
+                Vex(a, MAP_0F3A, PP_66, 0x4a, d, d, RM_CONST, Constant(a, op->p[1]), 1);          // vblendvps
+                Byte(a, REG_K << 4);
+                break;
+            case PATH_OP_SINE:
+                LoadConstant(a, d, op->p[1]);
+                FmaT(a, d, op->p[2]);
+                EmitSine(a, d);
+                Vex(a, MAP_0F, PP_NONE, 0x59, d, d, RM_CONST, Constant(a, op->p[0]), 0);          // vmulps
+                break;
+            case PATH_OP_POLY3:
+                LoadConstant(a, d, op->p[3]);
+                FmaT(a, d, op->p[2]);
+                FmaT(a, d, op->p[1]);
+                FmaT(a, d, op->p[0]);
+                break;
+            case PATH_OP_ADD:
+            case PATH_OP_MUL:
+                d -= 2;
+                Vex(a, MAP_0F, PP_NONE, op->op == PATH_OP_ADD ? 0x58 : 0x59, d, d, RM_REG, d + 1, 0);
+                top -= 2;
+                break;
+        }
+        top++;
+    }
+}
+
+// void kernel(const float *t [rdi], float *x [rsi], float *y [rdx], long count [rcx])
+static void EmitKernel(Assembler *a, const PathExpr *x, const PathExpr *y) {
+    Byte(a, 0x31);  // xor eax, eax
+    Byte(a, 0xc0);
+    a->usePins = false;
+    for (int i = 0; i < a->constantCount; i++) {
+        if (a->pinned[i] != 0) Vex(a, MAP_0F, PP_NONE, 0x10, a->pinned[i] - 1, 0, RM_CONST, i, 0);  // vmovups
+    }
+    a->usePins = true;
+    int loop = a->size;
+    Vex(a, MAP_0F, PP_NONE, 0x10, REG_T, 0, RM_MEM, 7, 0);        // vmovups ymm0, [rdi + rax]
+    EmitProgram(a, x);
+    Vex(a, MAP_0F, PP_NONE, 0x11, REG_STACK, 0, RM_MEM, 6, 0);    // vmovups [rsi + rax], ymm1
+    EmitProgram(a, y);
+    Vex(a, MAP_0F, PP_NONE, 0x11, REG_STACK, 0, RM_MEM, 2, 0);    // vmovups [rdx + rax], ymm1
+    Byte(a, 0x48), Byte(a, 0x83), Byte(a, 0xc0), Byte(a, 32);      // add rax, 32
+    Byte(a, 0x48), Byte(a, 0x83), Byte(a, 0xe9), Byte(a, 8);       // sub rcx, 8
+    Byte(a, 0x0f), Byte(a, 0x85);                                  // jnz loop
+    Dword(a, (unsigned)(loop - (a->size + 4)));
+    Byte(a, 0xc5), Byte(a, 0xf8), Byte(a, 0x77);                   // vzeroupper
+    Byte(a, 0xc3);                                                 // ret
+}
+
+// Assemble into a fresh page, constants 32-byte aligned after the code
+static bool Compile(PathJit *path) {
+    Assembler *a = calloc(1, sizeof(*a));
+    if (a == NULL) return false;
+
+    // First pass counts how often the loop reads each constant; the busiest
+    // ones get the free registers and the second pass emits the real code
+    EmitKernel(a, &path->x, &path->y);
+    int depth = path->x.depth > path->y.depth ? path->x.depth : path->y.depth;
+    for (int reg = REG_STACK + depth; reg < REG_STACK + REG_STACK_COUNT; reg++) {
+        int busiest = -1;
+        for (int i = 0; i < a->constantCount; i++) {
+            if (a->pinned[i] == 0 && (busiest < 0 || a->uses[i] > a->uses[busiest])) busiest = i;
+        }
+        if (busiest < 0) break;
+        a->pinned[busiest] = reg + 1;
+    }
+    a->size = 0;
+    a->fixupCount = 0;
+    EmitKernel(a, &path->x, &path->y);
+    if (a->overflow) {
+        free(a);
+        return false;
+    }
+
+    int pool = (a->size + 31) & ~31;
+    size_t bytes = (size_t)pool + 32 * (size_t)a->constantCount;
+    long page = sysconf(_SC_PAGESIZE);
+    bytes = (bytes + (size_t)page - 1) & ~((size_t)page - 1);
+    unsigned char *code = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        free(a);
+        return false;
+    }
+
+    for (int i = 0; i < a->fixupCount; i++) {
+        const Fixup *fixup = &a->fixups[i];
+        int displacement = pool + 32 * fixup->constant - (fixup->at + 4 + fixup->trailing);
+        memcpy(&a->code[fixup->at], &displacement, sizeof(displacement));
+    }
+    memcpy(code, a->code, (size_t)a->size);
+    memset(code + a->size, 0xcc, (size_t)(pool - a->size));  // int3 padding
+    for (int i = 0; i < a->constantCount; i++) {
+        for (int lane = 0; lane < 8; lane++) {
+            memcpy(code + pool + 32 * i + 4 * lane, &a->constants[i], sizeof(unsigned int));
+        }
+    }
+    free(a);
+
+    // Writable or executable, never both
+    if (mprotect(code, bytes, PROT_READ | PROT_EXEC) != 0) {
+        munmap(code, bytes);
+        return false;
+    }
+    path->code = code;
+    path->codeBytes = bytes;
+    path->kernel = (PathJitKernel)(void *)code;
+    return true;
+}
+
+static void Release(PathJit *path) {
+    if (path->code != NULL) munmap(path->code, path->codeBytes);
+}
+
+#else // !PATH_JIT_X86_64
+
+static bool Compile(PathJit *path) {
+    (void)path;
+    return false;
+}
+
+static void Release(PathJit *path) {
+    (void)path;
+}
+
+#endif // PATH_JIT_X86_64
+
+bool PathJitInit(PathJit *path, const PathExpr *x, const PathExpr *y, bool native) {
+    memset(path, 0, sizeof(*path));
+    if (x->count == 0 || y->count == 0) return false;
+    path->x = *x;
+    path->y = *y;
+
+#ifdef PATH_JIT_X86_64
+    native = native && GetCpuDispatch()->tier >= CPU_TIER_AVX2 &&
+             x->depth <= REG_STACK_COUNT && y->depth <= REG_STACK_COUNT;
+#endif
+    if (native) Compile(path);
+    return true;
+}
+
+void PathJitFree(PathJit *path) {
+    Release(path);
+    path->code = NULL;
+    path->codeBytes = 0;
+    path->kernel = NULL;
+}
+
+bool PathJitIsNative(const PathJit *path) {
+    return path->kernel != NULL;
+}
+
+void PathJitBatch(const PathJit *path, const float *t, float *x, float *y, int count) {
+    if (path->kernel == NULL) {
+        PathExprEvalBatch(&path->x, t, x, count);
+        PathExprEvalBatch(&path->y, t, y, count);
+        return;
+    }
+
+    int whole = count & ~7;
+    if (whole > 0) path->kernel(t, x, y, whole);
+    if (whole < count) {
+        // The tail runs as one padded group
+        int rest = count - whole;
+        float tailT[8] = {0}, tailX[8], tailY[8];
+        memcpy(tailT, t + whole, sizeof(float) * (size_t)rest);
+        path->kernel(tailT, tailX, tailY, 8);
+        memcpy(x + whole, tailX, sizeof(float) * (size_t)rest);
+        memcpy(y + whole, tailY, sizeof(float) * (size_t)rest);
+    }
+}
+
+Vector2 PathJitPoint(const PathJit *path, float t) {
+    return (Vector2){PathExprEval(&path->x, t), PathExprEval(&path->y, t)};
+}
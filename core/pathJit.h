@@ -0,0 +1,54 @@
+#ifndef PATH_JIT_H
+#define PATH_JIT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "pathExpr.h"
+#include "paths.h"
+
+// Path expressions compiled to AVX2 machine code at load time.
+//
+// PathJitInit turns the x and y programs of a path (pathExpr.h) into one
+// 8-lane loop written straight into an mmap'd page: every term becomes a
+// few VEX instructions on a register stack (ymm1-ymm11, with ymm0 holding
+// t and ymm12-ymm15 as scratch for the sine). Parameters become 32-byte
+// broadcast constants after the code; the ones the loop reads most are
+// loaded once into the stack registers the expression leaves free, the rest
+// stay memory operands. The page is made read-execute before first use.
+// The sine is the FastSin8 sequence of fastSin.h, and LINEAR, POLY3 and
+// SINE use the same fused multiply-adds as the AVX2 kernels of pathSpec.c,
+// so a JIT path agrees with the matching PATH_SPEC to one rounding (the
+// compiler also fuses some multiply-then-add pairs that the JIT keeps as two
+// instructions).
+//
+// The code is only generated on x86-64 Linux when the bound dispatch tier
+// is AVX2 or higher (so BALLCORE_TIER=sse2 turns it off) and the expression
+// fits in the register stack. Otherwise, or when the page cannot be mapped
+// executable, the path keeps working through the block interpreter of
+// pathExpr.c.
+
+typedef void (*PathJitKernel)(const float *t, float *x, float *y, long count);
+
+typedef struct {
+    PathExpr x;
+    PathExpr y;
+    unsigned char *code;  // mmap'd code and constants, NULL when interpreting
+    size_t codeBytes;
+    PathJitKernel kernel; // Whole groups of 8 only; NULL when interpreting
+} PathJit;
+
+// Compile the two programs; `native` false always interprets. Returns false
+// only for an empty program.
+bool PathJitInit(PathJit *path, const PathExpr *x, const PathExpr *y, bool native);
+void PathJitFree(PathJit *path);
+
+// Whether the path runs as machine code
+bool PathJitIsNative(const PathJit *path);
+
+// Same layout as CalculatePathBatch
+void PathJitBatch(const PathJit *path, const float *t, float *x, float *y, int count);
+
+// One position, through the interpreter
+Vector2 PathJitPoint(const PathJit *path, float t);
+
+#endif // PATH_JIT_H
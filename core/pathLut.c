@@ -0,0 +1,104 @@
+#include "pathLut.h"
+#include <math.h>
+#include <stdlib.h>
+
+bool PathLutInit(PathLut *lut, int path, int resolution) {
+    if (resolution < 1 || path < 0 || path >= PATH_COUNT) return false;
+
+    // One guard point before t = 0 and two after t = 1
+    int pointCount = resolution + 4;
+    lut->points = malloc(sizeof(float) * 2 * pointCount);
+    if (lut->points == NULL) return false;
+
+    lut->path = path;
+    lut->resolution = resolution;
+    lut->scale = (float)resolution;
+    for (int j = 0; j < pointCount; j++) {
+        double x, y;
+        PathEvaluateReference(path, (double)(j - 1) / resolution, &x, &y);
+        lut->points[2 * j] = (float)x;
+        lut->points[2 * j + 1] = (float)y;
+    }
+    return true;
+}
+
+void PathLutFree(PathLut *lut) {
+    free(lut->points);
+    lut->points = NULL;
+    lut->resolution = 0;
+}
+
+size_t PathLutBytes(const PathLut *lut) {
+    return sizeof(float) * 2 * (size_t)(lut->resolution + 4);
+}
+
+// Catmull-Rom spline through p1..p2 with neighbours p0 and p3
+static inline float CubicInterpolate(float p0, float p1, float p2, float p3, float f) {
+    return p1 + 0.5f * f * (p2 - p0 + f * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3
+                                    + f * (3.0f * (p1 - p2) + p3 - p0)));
+}
+
+// Locate the interval holding t (clamped to [0, 1]) and the offset inside it.
+// Interval i runs from point i + 1 to point i + 2 (point 0 is the guard).
+// The first test is written so NaN fails it too and samples t = 0, like the
+// maxss clamp of pathArcLength.c, instead of indexing with (int)NaN.
+static inline const float *FindInterval(const float *points, int resolution, float scale, float t, float *f) {
+    if (!(t > 0.0f)) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+
+    float u = t * scale;
+    int i = (int)u;
+    if (i > resolution - 1) i = resolution - 1; // t == 1 uses the last interval
+    *f = u - (float)i;
+    return points + 2 * i;
+}
+
+void PathLutSample(const PathLut *lut, int mode, float t, float *x, float *y) {
+    float f;
+    const float *p = FindInterval(lut->points, lut->resolution, lut->scale, t, &f);
+    if (mode == PATH_LUT_CUBIC) {
+        *x = CubicInterpolate(p[0], p[2], p[4], p[6], f);
+        *y = CubicInterpolate(p[1], p[3], p[5], p[7], f);
+    } else {
+        *x = p[2] + f * (p[4] - p[2]);
+        *y = p[3] + f * (p[5] - p[3]);
+    }
+}
+
+void PathLutSampleBatch(const PathLut *lut, int mode, const float *t, float *x, float *y, int count) {
+    // Copy the table description into locals: the output stores may alias
+    // *lut as far as the compiler knows, which would force a reload per sample
+    const float *points = lut->points;
+    const int resolution = lut->resolution;
+    const float scale = lut->scale;
+
+    if (mode == PATH_LUT_CUBIC) {
+        for (int i = 0; i < count; i++) {
+            float f;
+            const float *p = FindInterval(points, resolution, scale, t[i], &f);
+            x[i] = CubicInterpolate(p[0], p[2], p[4], p[6], f);
+            y[i] = CubicInterpolate(p[1], p[3], p[5], p[7], f);
+        }
+    } else {
+        for (int i = 0; i < count; i++) {
+            float f;
+            const float *p = FindInterval(points, resolution, scale, t[i], &f);
+            x[i] = p[2] + f * (p[4] - p[2]);
+            y[i] = p[3] + f * (p[5] - p[3]);
+        }
+    }
+}
+
+double PathLutMaxError(const PathLut *lut, int mode, int samples) {
+    double maxError = 0.0;
+    for (int i = 0; i < samples; i++) {
+        double t = (samples > 1) ? (double)i / (samples - 1) : 0.0;
+        double refX, refY;
+        float x, y;
+        PathEvaluateReference(lut->path, t, &refX, &refY);
+        PathLutSample(lut, mode, (float)t, &x, &y);
+        double error = hypot(x - refX, y - refY);
+        if (error > maxError) maxError = error;
+    }
+    return maxError;
+}
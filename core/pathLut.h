@@ -0,0 +1,47 @@
+#ifndef PATH_LUT_H
+#define PATH_LUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "pathBatch.h"
+
+// Precomputed path lookup tables.
+//
+// A table holds (x, y) for `resolution + 1` evenly spaced values of t in
+// [0, 1], plus one guard point before and two after so the cubic sampler
+// never needs to clamp its neighbours. Points are stored interleaved so one
+// lookup touches one cache line. At 256 intervals a table is about 2 KB and
+// four of them stay L1-resident; 4096 intervals is 32 KB per path.
+//
+// The shapes are sampled in double precision at build time, so the only
+// runtime error is the interpolation error reported by PathLutMaxError.
+// Interpolation smooths the step of the angular path over one interval;
+// that path is cheaper to evaluate directly anyway.
+
+#define PATH_LUT_LINEAR 0
+#define PATH_LUT_CUBIC 1
+
+typedef struct {
+    int path;         // PATH_* id the table was built for
+    int resolution;   // Number of intervals across t in [0, 1]
+    float scale;      // resolution as a float (t -> table position)
+    float *points;    // (x, y) pairs, resolution + 4 of them, guard first
+} PathLut;
+
+bool PathLutInit(PathLut *lut, int path, int resolution);
+void PathLutFree(PathLut *lut);
+
+// Footprint of the table in bytes
+size_t PathLutBytes(const PathLut *lut);
+
+// Sample one t (clamped to [0, 1], NaN taken as 0) with the given PATH_LUT_* mode
+void PathLutSample(const PathLut *lut, int mode, float t, float *x, float *y);
+
+// Sample `count` values of t into separate x and y arrays
+void PathLutSampleBatch(const PathLut *lut, int mode, const float *t, float *x, float *y, int count);
+
+// Largest distance in pixels between the table and the exact path over
+// `samples` evenly spaced values of t
+double PathLutMaxError(const PathLut *lut, int mode, int samples);
+
+#endif // PATH_LUT_H
@@ -0,0 +1,233 @@
+#include "pathSpec.h"
+#include "cpuDispatch.h"
+#include "fastSin.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PATH_SPEC_X86 1
+#endif
+
+typedef void (*SpecKernel)(const float *t, float *x, float *y, int count);
+
+// Each section below defines the terms as expressions over `tv`, the t of
+// the lanes being evaluated, and includes the spec list to emit one kernel
+// per path. Parameters go through (float) so they fold into constants.
+
+// ---------------------------------------------------------------------------
+// Scalar, also used for the tails of the vector kernels
+// ---------------------------------------------------------------------------
+
+#define CONST(c) ((float)(c))
+#define LINEAR(a, b) ((float)(a) * tv + (float)(b))
+#define STEP(edge, low, high) (tv < (float)(edge) ? (float)(low) : (float)(high))
+#define SINE(amp, freq, phase) ((float)(amp) * FastSinf((float)(freq) * tv + (float)(phase)))
+#define POLY3(c0, c1, c2, c3) \
+    ((((float)(c3) * tv + (float)(c2)) * tv + (float)(c1)) * tv + (float)(c0))
+#define ADD(a, b) ((a) + (b))
+#define MUL(a, b) ((a) * (b))
+
+#define PATH_SPEC(id, name, xExpr, yExpr)                                        \
+    static void Scalar_##id(const float *t, float *x, float *y, int count) {     \
+        for (int i = 0; i < count; i++) {                                        \
+            const float tv = t[i];                                               \
+            x[i] = xExpr;                                                        \
+            y[i] = yExpr;                                                        \
+        }                                                                        \
+    }                                                                            \
+    static Vector2 Point_##id(float tv) {                                        \
+        return (Vector2){xExpr, yExpr};                                          \
+    }
+#include "pathSpecs.def"
+#undef PATH_SPEC
+
+#undef CONST
+#undef LINEAR
+#undef STEP
+#undef SINE
+#undef POLY3
+#undef ADD
+#undef MUL
+
+#ifdef PATH_SPEC_X86
+
+// ---------------------------------------------------------------------------
+// SSE2: 4 lanes
+// ---------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static inline __m128 Select4(__m128 mask, __m128 whenTrue, __m128 whenFalse) {
+    return _mm_or_ps(_mm_and_ps(mask, whenTrue), _mm_andnot_ps(mask, whenFalse));
+}
+
+#define CONST(c) _mm_set1_ps((float)(c))
+#define LINEAR(a, b) _mm_add_ps(_mm_mul_ps(CONST(a), tv), CONST(b))
+#define STEP(edge, low, high) Select4(_mm_cmplt_ps(tv, CONST(edge)), CONST(low), CONST(high))
+#define SINE(amp, freq, phase) _mm_mul_ps(CONST(amp), FastSin4(LINEAR(freq, phase)))
+#define POLY3(c0, c1, c2, c3) \
+    _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(LINEAR(c3, c2), tv), CONST(c1)), tv), CONST(c0))
+#define ADD(a, b) _mm_add_ps(a, b)
+#define MUL(a, b) _mm_mul_ps(a, b)
+
+#define PATH_SPEC(id, name, xExpr, yExpr)                                        \
+    __attribute__((target("sse2")))                                              \
+    static void SSE_##id(const float *t, float *x, float *y, int count) {        \
+        int i = 0;                                                               \
+        for (; i + 4 <= count; i += 4) {                                         \
+            const __m128 tv = _mm_loadu_ps(t + i);                               \
+            _mm_storeu_ps(x + i, xExpr);                                         \
+            _mm_storeu_ps(y + i, yExpr);                                         \
+        }                                                                        \
+        Scalar_##id(t + i, x + i, y + i, count - i);                             \
+    }
+#include "pathSpecs.def"
+#undef PATH_SPEC
+
+#undef CONST
+#undef LINEAR
+#undef STEP
+#undef SINE
+#undef POLY3
+#undef ADD
+#undef MUL
+
+// ---------------------------------------------------------------------------
+// AVX2 + FMA: 8 lanes
+// ---------------------------------------------------------------------------
+
+#define CONST(c) _mm256_set1_ps((float)(c))
+#define LINEAR(a, b) _mm256_fmadd_ps(CONST(a), tv, CONST(b))
+#define STEP(edge, low, high) _mm256_blendv_ps(CONST(high), CONST(low), _mm256_cmp_ps(tv, CONST(edge), _CMP_LT_OQ))
+#define SINE(amp, freq, phase) _mm256_mul_ps(CONST(amp), FastSin8(LINEAR(freq, phase)))
+#define POLY3(c0, c1, c2, c3) \
+    _mm256_fmadd_ps(_mm256_fmadd_ps(LINEAR(c3, c2), tv, CONST(c1)), tv, CONST(c0))
+#define ADD(a, b) _mm256_add_ps(a, b)
+#define MUL(a, b) _mm256_mul_ps(a, b)
+
+#define PATH_SPEC(id, name, xExpr, yExpr)                                        \
+    __attribute__((target("avx2,fma")))                                          \
+    static void AVX2_##id(const float *t, float *x, float *y, int count) {       \
+        int i = 0;                                                               \
+        for (; i + 8 <= count; i += 8) {                                         \
+            const __m256 tv = _mm256_loadu_ps(t + i);                            \
+            _mm256_storeu_ps(x + i, xExpr);                                      \
+            _mm256_storeu_ps(y + i, yExpr);                                      \
+        }                                                                        \
+        Scalar_##id(t + i, x + i, y + i, count - i);                             \
+    }
+#include "pathSpecs.def"
+#undef PATH_SPEC
+
+#undef CONST
+#undef LINEAR
+#undef STEP
+#undef SINE
+#undef POLY3
+#undef ADD
+#undef MUL
+
+// ---------------------------------------------------------------------------
+// AVX-512F: 16 lanes
+// ---------------------------------------------------------------------------
+
+#define CONST(c) _mm512_set1_ps((float)(c))
+#define LINEAR(a, b) _mm512_fmadd_ps(CONST(a), tv, CONST(b))
+#define STEP(edge, low, high) _mm512_mask_blend_ps(_mm512_cmp_ps_mask(tv, CONST(edge), _CMP_LT_OQ), CONST(high), CONST(low))
+#define SINE(amp, freq, phase) _mm512_mul_ps(CONST(amp), FastSin16(LINEAR(freq, phase)))
+#define POLY3(c0, c1, c2, c3) \
+    _mm512_fmadd_ps(_mm512_fmadd_ps(LINEAR(c3, c2), tv, CONST(c1)), tv, CONST(c0))
+#define ADD(a, b) _mm512_add_ps(a, b)
+#define MUL(a, b) _mm512_mul_ps(a, b)
+
+#define PATH_SPEC(id, name, xExpr, yExpr)                                        \
+    __attribute__((target("avx512f")))                                           \
+    static void AVX512_##id(const float *t, float *x, float *y, int count) {     \
+        int i = 0;                                                               \
+        for (; i + 16 <= count; i += 16) {                                       \
+            const __m512 tv = _mm512_loadu_ps(t + i);                            \
+            _mm512_storeu_ps(x + i, xExpr);                                      \
+            _mm512_storeu_ps(y + i, yExpr);                                      \
+        }                                                                        \
+        Scalar_##id(t + i, x + i, y + i, count - i);                             \
+    }
+#include "pathSpecs.def"
+#undef PATH_SPEC
+
+#undef CONST
+#undef LINEAR
+#undef STEP
+#undef SINE
+#undef POLY3
+#undef ADD
+#undef MUL
+
+#define SPEC_KERNEL_SSE(id) SSE_##id
+#define SPEC_KERNEL_AVX2(id) AVX2_##id
+#define SPEC_KERNEL_AVX512(id) AVX512_##id
+
+#else // !PATH_SPEC_X86
+
+#define SPEC_KERNEL_SSE(id) Scalar_##id
+#define SPEC_KERNEL_AVX2(id) Scalar_##id
+#define SPEC_KERNEL_AVX512(id) Scalar_##id
+
+#endif // PATH_SPEC_X86
+
+// ---------------------------------------------------------------------------
+// Tables indexed by PATH_SPEC_* id
+// ---------------------------------------------------------------------------
+
+const char *pathSpecNames[PATH_SPEC_COUNT] = {
+#define PATH_SPEC(id, name, x, y) name,
+#include "pathSpecs.def"
+#undef PATH_SPEC
+};
+
+const PathFunction pathSpecFunctions[PATH_SPEC_COUNT] = {
+#define PATH_SPEC(id, name, x, y) Point_##id,
+#include "pathSpecs.def"
+#undef PATH_SPEC
+};
+
+static const SpecKernel scalarKernels[PATH_SPEC_COUNT] = {
+#define PATH_SPEC(id, name, x, y) Scalar_##id,
+#include "pathSpecs.def"
+#undef PATH_SPEC
+};
+
+static const SpecKernel sseKernels[PATH_SPEC_COUNT] = {
+#define PATH_SPEC(id, name, x, y) SPEC_KERNEL_SSE(id),
+#include "pathSpecs.def"
+#undef PATH_SPEC
+};
+
+static const SpecKernel avx2Kernels[PATH_SPEC_COUNT] = {
+#define PATH_SPEC(id, name, x, y) SPEC_KERNEL_AVX2(id),
+#include "pathSpecs.def"
+#undef PATH_SPEC
+};
+
+static const SpecKernel avx512Kernels[PATH_SPEC_COUNT] = {
+#define PATH_SPEC(id, name, x, y) SPEC_KERNEL_AVX512(id),
+#include "pathSpecs.def"
+#undef PATH_SPEC
+};
+
+void PathSpecBatchScalar(int spec, const float *t, float *x, float *y, int count) {
+    if (spec >= 0 && spec < PATH_SPEC_COUNT) scalarKernels[spec](t, x, y, count);
+}
+
+void PathSpecBatchSSE(int spec, const float *t, float *x, float *y, int count) {
+    if (spec >= 0 && spec < PATH_SPEC_COUNT) sseKernels[spec](t, x, y, count);
+}
+
+void PathSpecBatchAVX2(int spec, const float *t, float *x, float *y, int count) {
+    if (spec >= 0 && spec < PATH_SPEC_COUNT) avx2Kernels[spec](t, x, y, count);
+}
+
+void PathSpecBatchAVX512(int spec, const float *t, float *x, float *y, int count) {
+    if (spec >= 0 && spec < PATH_SPEC_COUNT) avx512Kernels[spec](t, x, y, count);
+}
+
+void PathSpecBatch(int spec, const float *t, float *x, float *y, int count) {
+    GetCpuDispatch()->pathSpecBatch(spec, t, x, y, count);
+}
@@ -0,0 +1,53 @@
+#ifndef PATH_SPEC_H
+#define PATH_SPEC_H
+
+#include "paths.h"
+
+// Paths described declaratively and compiled into kernels at build time.
+//
+// Each row of pathSpecs.def names a path and gives x and y as expressions
+// in t built from these terms:
+//   CONST(c)                  c
+//   LINEAR(a, b)              a * t + b
+//   STEP(edge, low, high)     low for t < edge, high from there on
+//   SINE(amp, freq, phase)    amp * sin(freq * t + phase)
+//   POLY3(c0, c1, c2, c3)     c0 + c1 * t + c2 * t^2 + c3 * t^3 (Horner)
+//   ADD(a, b), MUL(a, b)      sum and product of two terms
+//
+// pathSpec.c includes the list once per instruction set with the terms
+// defined as that set's operations, so the preprocessor writes a scalar, an
+// SSE2, an AVX2 (with FMA) and an AVX-512 kernel for every path. The kernels
+// are straight-line arithmetic: parameters are literals the compiler folds
+// and hoists out of the loop, a STEP is a compare and blend, and sines use
+// fastSin.h. Adding a path is one row in pathSpecs.def, no asm.
+//
+// Spec ids are separate from the PATH_* ids; the first four specs restate
+// the built-in paths in the same order.
+
+#define PATH_SPEC_PI 3.14159265358979323846
+
+enum {
+#define PATH_SPEC(id, name, x, y) PATH_SPEC_##id,
+#include "pathSpecs.def"
+#undef PATH_SPEC
+    PATH_SPEC_COUNT
+};
+
+// Lower-case spec names for reports
+extern const char *pathSpecNames[PATH_SPEC_COUNT];
+
+// One position at a time, indexed by PATH_SPEC_* id
+extern const PathFunction pathSpecFunctions[PATH_SPEC_COUNT];
+
+// Batched evaluation of spec `spec` with the widest kernel the CPU supports
+// (see cpuDispatch.h); same layout as CalculatePathBatch
+void PathSpecBatch(int spec, const float *t, float *x, float *y, int count);
+
+// Width-specific kernels: scalar, 4-wide SSE2, 8-wide AVX2, 16-wide AVX-512.
+// The caller must make sure the CPU supports the instruction set it picks.
+void PathSpecBatchScalar(int spec, const float *t, float *x, float *y, int count);
+void PathSpecBatchSSE(int spec, const float *t, float *x, float *y, int count);
+void PathSpecBatchAVX2(int spec, const float *t, float *x, float *y, int count);
+void PathSpecBatchAVX512(int spec, const float *t, float *x, float *y, int count);
+
+#endif // PATH_SPEC_H
@@ -0,0 +1,245 @@
+#include "pathStepper.h"
+#include <float.h>
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PATH_STEPPER_X86 1
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Rounding error of one float operation, relative
+#define STEPPER_EPS (FLT_EPSILON / 2.0)
+
+// Error added per rotation step, relative to the unit (sin, cos) vector:
+// two rounded products and a rounded sum per component, plus the angle error
+// of the rounded (sd, cd) pair
+#define STEPPER_STEP_ERROR (9.0 * STEPPER_EPS)
+
+// Recompute (sin, cos) of the phase at the current t in double precision.
+// This runs once every PATH_STEPPER_RESYNC_INTERVAL steps, so the libm cost
+// is amortised.
+static void SeedPhase(PathStepper *stepper) {
+    double phase = (double)stepper->freq * stepper->t;
+    stepper->s = (float)sin(phase);
+    stepper->c = (float)cos(phase);
+}
+
+// Restart the sweep at t
+static void Reseed(PathStepper *stepper, float t) {
+    stepper->t0 = t;
+    stepper->n = 0;
+    stepper->t = t;
+    SeedPhase(stepper);
+}
+
+void PathStepperInit(PathStepper *stepper, int path, float t0, float dt) {
+    stepper->path = path;
+    stepper->n = 0;
+    switch (path) {
+        case PATH_CONVEX: stepper->freq = (float)M_PI; stepper->amp = -200.0f; break;
+        case PATH_SINUSOIDAL: stepper->freq = (float)(4.0 * M_PI); stepper->amp = 100.0f; break;
+        default: stepper->freq = 0.0f; stepper->amp = 0.0f; break;
+    }
+    PathStepperSetStep(stepper, dt);
+    Reseed(stepper, t0);
+    PathStepperUpdatePosition(stepper);
+}
+
+// Only the phase: t0 and n stay, so t = t0 + n * dt keeps its one rounding
+void PathStepperResync(PathStepper *stepper) {
+    SeedPhase(stepper);
+    PathStepperUpdatePosition(stepper);
+}
+
+void PathStepperAdvance(PathStepper *stepper, float *x, float *y, int count) {
+    const float mid = SCREEN_HEIGHT / 2.0f;
+    const float t0 = stepper->t0, dt = stepper->dt, amp = stepper->amp;
+    const int angular = (stepper->path == PATH_ANGULAR);
+    long long n = stepper->n;
+    int i = 0;
+
+    // The angular step is added on top of mid + amp * sin: -100 below t = 0.5
+    // and +100 from there on. Paths without a sine have amp = 0 and freq = 0,
+    // so their (sin, cos) lanes simply stay at (0, 1).
+    const float stepLow = angular ? -100.0f : 0.0f;
+    const float stepJump = angular ? 200.0f : 0.0f;
+
+    // Lane k carries step n + 1 + k and is rotated by LANES phase steps at a
+    // time. The lanes are reseeded in double precision at the start of every
+    // chunk, so each one sees at most RESYNC_INTERVAL / LANES rotations.
+    const double delta = (double)stepper->freq * dt;
+    const double sd = sin(delta), cd = cos(delta);
+    const float sdLanes = (float)sin(delta * PATH_STEPPER_LANES);
+    const float cdLanes = (float)cos(delta * PATH_STEPPER_LANES);
+    float s[PATH_STEPPER_LANES], c[PATH_STEPPER_LANES];
+
+    while (count - i >= PATH_STEPPER_LANES) {
+        double phase = (double)stepper->freq * (t0 + (float)(n + 1) * dt);
+        double ls = sin(phase), lc = cos(phase);
+        for (int k = 0; k < PATH_STEPPER_LANES; k++) {
+            s[k] = (float)ls;
+            c[k] = (float)lc;
+            double next = ls * cd + lc * sd;
+            lc = lc * cd - ls * sd;
+            ls = next;
+        }
+
+        int chunk = count - i;
+        if (chunk > PATH_STEPPER_RESYNC_INTERVAL) chunk = PATH_STEPPER_RESYNC_INTERVAL;
+        chunk -= chunk % PATH_STEPPER_LANES;
+
+#ifdef PATH_STEPPER_X86
+        // Two SSE registers of four lanes each
+        const __m128 laneLow = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        const __m128 laneHigh = _mm_setr_ps(4.0f, 5.0f, 6.0f, 7.0f);
+        const __m128 vT0 = _mm_set1_ps(t0), vDt = _mm_set1_ps(dt);
+        const __m128 vWidth = _mm_set1_ps((float)SCREEN_WIDTH);
+        const __m128 vMid = _mm_set1_ps(mid + stepLow), vAmp = _mm_set1_ps(amp);
+        const __m128 vJump = _mm_set1_ps(stepJump), vHalfT = _mm_set1_ps(0.5f);
+        const __m128 vSd = _mm_set1_ps(sdLanes), vCd = _mm_set1_ps(cdLanes);
+        const __m128 threeHalves = _mm_set1_ps(1.5f), half = _mm_set1_ps(0.5f);
+        __m128 s0 = _mm_loadu_ps(s), s1 = _mm_loadu_ps(s + 4);
+        __m128 c0 = _mm_loadu_ps(c), c1 = _mm_loadu_ps(c + 4);
+
+        for (int j = 0; j < chunk; j += PATH_STEPPER_LANES) {
+            // Step numbers in float, as (float)n in PathStepperStep; n is
+            // 64-bit, so it cannot go through 32-bit integer lanes
+            __m128 base = _mm_set1_ps((float)(n + 1 + j));
+            __m128 t0v = _mm_add_ps(vT0, _mm_mul_ps(_mm_add_ps(base, laneLow), vDt));
+            __m128 t1v = _mm_add_ps(vT0, _mm_mul_ps(_mm_add_ps(base, laneHigh), vDt));
+            __m128 y0 = _mm_add_ps(vMid, _mm_and_ps(_mm_cmpge_ps(t0v, vHalfT), vJump));
+            __m128 y1 = _mm_add_ps(vMid, _mm_and_ps(_mm_cmpge_ps(t1v, vHalfT), vJump));
+            _mm_storeu_ps(x + i + j, _mm_mul_ps(t0v, vWidth));
+            _mm_storeu_ps(x + i + j + 4, _mm_mul_ps(t1v, vWidth));
+            _mm_storeu_ps(y + i + j, _mm_add_ps(y0, _mm_mul_ps(vAmp, s0)));
+            _mm_storeu_ps(y + i + j + 4, _mm_add_ps(y1, _mm_mul_ps(vAmp, s1)));
+
+            // Rotate every lane; the last rotation of a chunk is never used
+            __m128 ns0 = _mm_add_ps(_mm_mul_ps(s0, vCd), _mm_mul_ps(c0, vSd));
+            __m128 ns1 = _mm_add_ps(_mm_mul_ps(s1, vCd), _mm_mul_ps(c1, vSd));
+            c0 = _mm_sub_ps(_mm_mul_ps(c0, vCd), _mm_mul_ps(s0, vSd));
+            c1 = _mm_sub_ps(_mm_mul_ps(c1, vCd), _mm_mul_ps(s1, vSd));
+            s0 = ns0;
+            s1 = ns1;
+
+            if (((j + PATH_STEPPER_LANES) & (PATH_STEPPER_RENORM_INTERVAL - 1)) == 0) {
+                __m128 k0 = _mm_sub_ps(threeHalves, _mm_mul_ps(half, _mm_add_ps(_mm_mul_ps(s0, s0), _mm_mul_ps(c0, c0))));
+                __m128 k1 = _mm_sub_ps(threeHalves, _mm_mul_ps(half, _mm_add_ps(_mm_mul_ps(s1, s1), _mm_mul_ps(c1, c1))));
+                s0 = _mm_mul_ps(s0, k0);
+                c0 = _mm_mul_ps(c0, k0);
+                s1 = _mm_mul_ps(s1, k1);
+                c1 = _mm_mul_ps(c1, k1);
+            }
+        }
+#else
+        for (int j = 0; j < chunk; j += PATH_STEPPER_LANES) {
+            for (int k = 0; k < PATH_STEPPER_LANES; k++) {
+                float t = t0 + (float)(n + 1 + j + k) * dt;
+                x[i + j + k] = t * SCREEN_WIDTH;
+                y[i + j + k] = mid + stepLow + (t >= 0.5f ? stepJump : 0.0f) + amp * s[k];
+            }
+            // Rotate every lane; the last rotation of a chunk is never used
+            int renorm = ((j + PATH_STEPPER_LANES) & (PATH_STEPPER_RENORM_INTERVAL - 1)) == 0;
+            for (int k = 0; k < PATH_STEPPER_LANES; k++) {
+                float ns = s[k] * cdLanes + c[k] * sdLanes;
+                float nc = c[k] * cdLanes - s[k] * sdLanes;
+                if (renorm) {
+                    float f = 1.5f - 0.5f * (ns * ns + nc * nc);
+                    ns *= f;
+                    nc *= f;
+                }
+                s[k] = ns;
+                c[k] = nc;
+            }
+        }
+#endif
+        i += chunk;
+        n += chunk;
+    }
+
+    // Hand the sweep back to the single-step path at the last position and
+    // finish any remainder there
+    stepper->n = n;
+    stepper->t = t0 + (float)n * dt;
+    if (i > 0) {
+        SeedPhase(stepper);
+        PathStepperUpdatePosition(stepper);
+    }
+    for (; i < count; i++) {
+        PathStepperStep(stepper);
+        x[i] = stepper->x;
+        y[i] = stepper->y;
+    }
+}
+
+void PathStepperSeek(PathStepper *stepper, float t) {
+    Reseed(stepper, t);
+    PathStepperUpdatePosition(stepper);
+}
+
+void PathStepperSetStep(PathStepper *stepper, float dt) {
+    double delta = (double)stepper->freq * dt;
+    stepper->dt = dt;
+    stepper->sd = (float)sin(delta);
+    stepper->cd = (float)cos(delta);
+
+    // Continue from the current t so the new step starts where the old one left off
+    if (stepper->n != 0) {
+        Reseed(stepper, stepper->t);
+    }
+}
+
+double PathStepperDriftBound(const PathStepper *stepper) {
+    // x = t * SCREEN_WIDTH and y = mid + amp * s each round once or twice
+    double bound = (SCREEN_WIDTH + SCREEN_HEIGHT / 2.0 + fabs(stepper->amp)) * 2.0 * STEPPER_EPS;
+    if (stepper->freq != 0.0f) {
+        // Angle error grows by STEP_ERROR per step until the next resync; the
+        // length error only until the next renormalisation
+        double angle = 2.0 * STEPPER_EPS + PATH_STEPPER_RESYNC_INTERVAL * STEPPER_STEP_ERROR;
+        double length = 2.0 * STEPPER_EPS + PATH_STEPPER_RENORM_INTERVAL * STEPPER_STEP_ERROR;
+        bound += fabs(stepper->amp) * (angle + length);
+    }
+    return bound;
+}
+
+// Distance between a stepper position and the exact path at the same t
+static double DriftAt(int path, float t, float x, float y) {
+    // The angular path jumps at t = 0.5; a float t that lands on the other
+    // side of the step than its double value is not drift
+    if (path == PATH_ANGULAR && fabs(t - 0.5) < 1e-6) return 0.0;
+
+    double refX, refY;
+    PathEvaluateReference(path, t, &refX, &refY);
+    return hypot(x - refX, y - refY);
+}
+
+double PathStepperMeasureDrift(int path, float t0, float dt, int steps) {
+    PathStepper stepper;
+    double maxError = 0.0;
+
+    // Single steps
+    PathStepperInit(&stepper, path, t0, dt);
+    for (int i = 0; i < steps; i++) {
+        PathStepperStep(&stepper);
+        double error = DriftAt(path, stepper.t, stepper.x, stepper.y);
+        if (error > maxError) maxError = error;
+    }
+
+    // The same sweep through PathStepperAdvance, in blocks
+    float x[256], y[256];
+    PathStepperInit(&stepper, path, t0, dt);
+    for (int done = 0; done < steps; done += 256) {
+        int block = (steps - done < 256) ? steps - done : 256;
+        PathStepperAdvance(&stepper, x, y, block);
+        for (int i = 0; i < block; i++) {
+            float t = t0 + (float)(done + i + 1) * dt;
+            double error = DriftAt(path, t, x[i], y[i]);
+            if (error > maxError) maxError = error;
+        }
+    }
+    return maxError;
+}
@@ -0,0 +1,101 @@
+#ifndef PATH_STEPPER_H
+#define PATH_STEPPER_H
+
+#include "paths.h"
+
+// Incremental path evaluation for fixed-step sweeps.
+//
+// Instead of computing sinf(freq * t) from scratch every step, the stepper
+// keeps (sin, cos) of the current phase and rotates it by the constant phase
+// step with the angle-addition formulas: four multiplies and two adds.
+// t itself is recomputed as t0 + n * dt so it does not accumulate rounding:
+// t0 only moves on a seek or a step change, and n counts every step since
+// in 64 bits, so the periodic resyncs below leave both alone.
+//
+// Rounding makes the rotated pair drift in length and in angle. The length is
+// pulled back to 1 every PATH_STEPPER_RENORM_INTERVAL steps with one Newton
+// step for 1/sqrt, and the angle is resynchronised from a direct sine every
+// PATH_STEPPER_RESYNC_INTERVAL steps. PathStepperDriftBound gives the
+// worst-case position error that follows from those intervals, and
+// PathStepperMeasureDrift checks a sweep against direct evaluation.
+
+#define PATH_STEPPER_RENORM_INTERVAL 64
+#define PATH_STEPPER_RESYNC_INTERVAL 256
+#define PATH_STEPPER_LANES 8
+
+typedef struct {
+    int path;          // PATH_* id
+    float t0;          // t at the last seek or step change
+    float dt;          // Step in t per PathStepperStep
+    long long n;       // Steps taken since t0
+    float t;           // Current t
+    float x, y;        // Current position
+    float freq;        // Phase per unit of t (0 for paths without a sine)
+    float amp;         // Sine amplitude in pixels
+    float s, c;        // sin and cos of the current phase
+    float sd, cd;      // sin and cos of the phase step
+} PathStepper;
+
+void PathStepperInit(PathStepper *stepper, int path, float t0, float dt);
+
+// Slow paths of PathStepperStep, kept out of line
+void PathStepperResync(PathStepper *stepper);
+
+static inline void PathStepperUpdatePosition(PathStepper *stepper) {
+    const float mid = SCREEN_HEIGHT / 2.0f;
+    stepper->x = stepper->t * SCREEN_WIDTH;
+    if (stepper->freq != 0.0f) {
+        stepper->y = mid + stepper->amp * stepper->s;
+    } else if (stepper->path == PATH_ANGULAR) {
+        stepper->y = mid + (stepper->t < 0.5f ? -100.0f : 100.0f);
+    } else {
+        stepper->y = mid;
+    }
+}
+
+// Advance by one step of dt. Inline so a sweep keeps the state in registers.
+static inline void PathStepperStep(PathStepper *stepper) {
+    stepper->n++;
+    stepper->t = stepper->t0 + (float)stepper->n * stepper->dt;
+
+    if (stepper->freq != 0.0f) {
+        if ((stepper->n & (PATH_STEPPER_RESYNC_INTERVAL - 1)) == 0) {
+            PathStepperResync(stepper);
+            return;
+        }
+
+        // Rotate (sin, cos) by the phase step
+        float s = stepper->s * stepper->cd + stepper->c * stepper->sd;
+        float c = stepper->c * stepper->cd - stepper->s * stepper->sd;
+
+        if ((stepper->n & (PATH_STEPPER_RENORM_INTERVAL - 1)) == 0) {
+            // One Newton step of 1/sqrt(s^2 + c^2) around 1
+            float k = 1.5f - 0.5f * (s * s + c * c);
+            s *= k;
+            c *= k;
+        }
+        stepper->s = s;
+        stepper->c = c;
+    }
+    PathStepperUpdatePosition(stepper);
+}
+
+// Take `count` steps and write every position to x and y. This keeps the
+// state in registers and runs PATH_STEPPER_LANES interleaved recurrences so
+// the multiply latency of one rotation does not serialise the whole sweep.
+void PathStepperAdvance(PathStepper *stepper, float *x, float *y, int count);
+
+// Jump to a new t (wrap-around) or change the step (speed-up, reversal).
+// Both reseed from direct evaluation.
+void PathStepperSeek(PathStepper *stepper, float t);
+void PathStepperSetStep(PathStepper *stepper, float dt);
+
+// Worst-case distance in pixels between the stepper and the exact path,
+// valid for any number of steps
+double PathStepperDriftBound(const PathStepper *stepper);
+
+// Largest distance in pixels between a sweep of `steps` steps and the exact
+// path evaluated in double precision at the same t values
+double PathStepperMeasureDrift(int path, float t0, float dt, int steps);
+
+#endif // PATH_STEPPER_H
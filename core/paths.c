@@ -0,0 +1,103 @@
+#include "paths.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+Vector2 CalculateStraightPath(float t) {
+    return (Vector2){t * SCREEN_WIDTH, SCREEN_HEIGHT / 2};
+}
+
+Vector2 CalculateAngularPath(float t) {
+    if (t < 0.5f) {
+        return (Vector2){t * SCREEN_WIDTH, SCREEN_HEIGHT / 2 - 100};
+    } else {
+        return (Vector2){t * SCREEN_WIDTH, SCREEN_HEIGHT / 2 + 100};
+    }
+}
+
+Vector2 CalculateConvexPath(float t) {
+    float y = SCREEN_HEIGHT / 2 - 200 * sinf(t * (float)M_PI);
+    return (Vector2){t * SCREEN_WIDTH, y};
+}
+
+Vector2 CalculateSinusoidalPath(float t) {
+    float y = SCREEN_HEIGHT / 2 + 100 * sinf(t * 4 * (float)M_PI);
+    return (Vector2){t * SCREEN_WIDTH, y};
+}
+
+const PathFunction pathFunctions[PATH_COUNT] = {
+    CalculateStraightPath, CalculateAngularPath, CalculateConvexPath, CalculateSinusoidalPath
+};
+
+const PathFunction pathFunctionsAsm[PATH_COUNT] = {
+    CalculateStraightPathAsm, CalculateAngularPathAsm, CalculateConvexPathAsm, CalculateSinusoidalPathAsm
+};
+
+const char *pathNames[PATH_COUNT] = {"straight", "angular", "convex", "sinusoidal"};
+
+void PathEvaluateReference(int path, double t, double *x, double *y) {
+    const double mid = SCREEN_HEIGHT / 2.0;
+    *x = t * SCREEN_WIDTH;
+    switch (path) {
+        case PATH_STRAIGHT: *y = mid; break;
+        case PATH_ANGULAR: *y = mid + (t < 0.5 ? -100.0 : 100.0); break;
+        case PATH_CONVEX: *y = mid - 200.0 * sin(t * M_PI); break;
+        case PATH_SINUSOIDAL: *y = mid + 100.0 * sin(t * 4.0 * M_PI); break;
+        default: *y = mid; break;
+    }
+}
+
+int PathIdOf(PathFunction function) {
+    for (int path = 0; path < PATH_COUNT; path++) {
+        if (function == pathFunctions[path] || function == pathFunctionsAsm[path]) return path;
+    }
+    return -1;
+}
+
+// First angle in [a, b] whose sine lies in [low, high], or -1 (angles are
+// non-negative here). Starting outside the band, the sine enters it where it
+// first equals low or high, so only those two levels need solving.
+static double FirstAngleInSineBand(double a, double b, double low, double high) {
+    if (low > 1.0 || high < -1.0 || low > high) return -1.0;
+    double s = sin(a);
+    if (s >= low && s <= high) return a;
+
+    double first = b + 1.0;
+    double levels[2] = {low, high};
+    for (int i = 0; i < 2; i++) {
+        if (levels[i] < -1.0 || levels[i] > 1.0) continue;
+        double bases[2] = {asin(levels[i]), M_PI - asin(levels[i])};
+        for (int j = 0; j < 2; j++) {
+            double angle = bases[j] + 2.0 * M_PI * ceil((a - bases[j]) / (2.0 * M_PI));
+            if (angle < first) first = angle;
+        }
+    }
+    return first <= b ? first : -1.0;
+}
+
+double PathFirstTimeInBand(int path, double t0, double t1, double top, double bottom) {
+    const double mid = SCREEN_HEIGHT / 2.0;
+    if (t0 > t1) return -1.0;
+    switch (path) {
+        case PATH_STRAIGHT:
+            return mid >= top && mid <= bottom ? t0 : -1.0;
+        case PATH_ANGULAR:
+            if (t0 < 0.5 && mid - 100.0 >= top && mid - 100.0 <= bottom) return t0;
+            if (t1 >= 0.5 && mid + 100.0 >= top && mid + 100.0 <= bottom) return t0 > 0.5 ? t0 : 0.5;
+            return -1.0;
+        case PATH_CONVEX: {
+            // y = mid - 200 sin(pi t)
+            double angle = FirstAngleInSineBand(t0 * M_PI, t1 * M_PI, (mid - bottom) / 200.0, (mid - top) / 200.0);
+            return angle < 0.0 ? -1.0 : angle / M_PI;
+        }
+        case PATH_SINUSOIDAL: {
+            // y = mid + 100 sin(4 pi t)
+            double angle = FirstAngleInSineBand(t0 * 4.0 * M_PI, t1 * 4.0 * M_PI, (top - mid) / 100.0, (bottom - mid) / 100.0);
+            return angle < 0.0 ? -1.0 : angle / (4.0 * M_PI);
+        }
+        default:
+            return -1.0;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef PATHS_H
+#define PATHS_H
+
+// Ball paths shared by every front-end.
+//
+// t runs from 0 (left edge) to 1 (right edge) and maps to x = t * SCREEN_WIDTH
+// on all paths; the paths differ only in y:
+//   straight    SCREEN_HEIGHT / 2
+//   angular     SCREEN_HEIGHT / 2 - 100 for t < 0.5, + 100 from there on
+//   convex      SCREEN_HEIGHT / 2 - 200 * sin(pi * t)
+//   sinusoidal  SCREEN_HEIGHT / 2 + 100 * sin(4 * pi * t)
+
+#define SCREEN_WIDTH 800
+#define SCREEN_HEIGHT 600
+
+#define PATH_STRAIGHT 0
+#define PATH_ANGULAR 1
+#define PATH_CONVEX 2
+#define PATH_SINUSOIDAL 3
+#define PATH_COUNT 4
+
+// raylib's Vector2 when a front-end has included raylib.h first, otherwise an
+// identical definition so the core builds without raylib
+#if !defined(RL_VECTOR2_TYPE) && !defined(RAYLIB_H)
+typedef struct Vector2 {
+    float x;
+    float y;
+} Vector2;
+#define RL_VECTOR2_TYPE
+#endif
+
+typedef Vector2 (*PathFunction)(float t);
+
+// Plain C implementation
+Vector2 CalculateStraightPath(float t);
+Vector2 CalculateAngularPath(float t);
+Vector2 CalculateConvexPath(float t);
+Vector2 CalculateSinusoidalPath(float t);
+
+// Hand-written SSE inline assembly implementation (pathAsm.c)
+Vector2 CalculateStraightPathAsm(float t);
+Vector2 CalculateAngularPathAsm(float t);
+Vector2 CalculateConvexPathAsm(float t);
+Vector2 CalculateSinusoidalPathAsm(float t);
+
+// Both implementations indexed by PATH_* id
+extern const PathFunction pathFunctions[PATH_COUNT];
+extern const PathFunction pathFunctionsAsm[PATH_COUNT];
+
+// Lower-case path names for reports ("straight", "angular", ...)
+extern const char *pathNames[PATH_COUNT];
+
+// Exact path position in double precision, the reference for accuracy checks
+void PathEvaluateReference(int path, double t, double *x, double *y);
+
+// PATH_* id of a function from either table, -1 for any other function
+int PathIdOf(PathFunction function);
+
+// First t in [t0, t1] at which the path's y lies in [top, bottom], solved in
+// closed form from the equations above (asin for the curved paths), or -1
+// when y stays outside the band
+double PathFirstTimeInBand(int path, double t0, double t1, double top, double bottom);
+
+#endif // PATHS_H
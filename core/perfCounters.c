@@ -0,0 +1,151 @@
+#include "perfCounters.h"
+#include <stdio.h>
+#include <string.h>
+
+const char *perfCounterNames[PERF_COUNTER_COUNT] = {"cycles", "instructions", "branch-misses", "l1d-misses", "llc-misses"};
+
+#if defined(__linux__)
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// read() layout with PERF_FORMAT_TOTAL_TIME_ENABLED | _RUNNING
+typedef struct {
+    unsigned long long value;
+    unsigned long long enabled;
+    unsigned long long running;
+} PerfReading;
+
+static const struct {
+    unsigned int type;
+    unsigned long long config;
+} perfEvents[PERF_COUNTER_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+};
+
+static int Paranoid(void) {
+    int level = -9;
+    FILE *file = fopen("/proc/sys/kernel/perf_event_paranoid", "r");
+    if (file == NULL) return level;
+    if (fscanf(file, "%d", &level) != 1) level = -9;
+    fclose(file);
+    return level;
+}
+
+static void DescribeError(PerfCounters *counters, const char *name, int error) {
+    if (error == EACCES || error == EPERM) {
+        snprintf(counters->error, sizeof(counters->error), "%s: not permitted (kernel.perf_event_paranoid = %d)",
+                 name, Paranoid());
+    } else if (error == ENOENT || error == EOPNOTSUPP || error == ENODEV) {
+        snprintf(counters->error, sizeof(counters->error), "%s: not supported here (no PMU, e.g. in a VM)", name);
+    } else {
+        snprintf(counters->error, sizeof(counters->error), "%s: %s", name, strerror(error));
+    }
+}
+
+bool PerfCountersOpen(PerfCounters *counters) {
+    counters->opened = 0;
+    counters->error[0] = '\0';
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = perfEvents[i].type;
+        attr.config = perfEvents[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // This thread, any CPU, no group
+        counters->fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (counters->fds[i] >= 0) {
+            counters->opened++;
+        } else if (counters->error[0] == '\0') {
+            DescribeError(counters, perfCounterNames[i], errno);
+        }
+    }
+    return counters->opened > 0;
+}
+
+void PerfCountersClose(PerfCounters *counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] >= 0) close(counters->fds[i]);
+        counters->fds[i] = -1;
+    }
+    counters->opened = 0;
+}
+
+static bool ReadCounter(int fd, PerfReading *reading) {
+    return read(fd, reading, sizeof(*reading)) == (ssize_t)sizeof(*reading);
+}
+
+// The reset ioctl zeroes the count but not the times, so counts and times
+// are both taken as differences from a reading here
+void PerfCountersStart(PerfCounters *counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        PerfReading reading = {0, 0, 0};
+        if (counters->fds[i] >= 0) ReadCounter(counters->fds[i], &reading);
+        counters->baseline[i][0] = reading.value;
+        counters->baseline[i][1] = reading.enabled;
+        counters->baseline[i][2] = reading.running;
+    }
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] >= 0) ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void PerfCountersStop(PerfCounters *counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] >= 0) ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+}
+
+void PerfCountersRead(const PerfCounters *counters, PerfSample *sample) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        PerfReading reading;
+        sample->values[i] = -1.0;
+        if (counters->fds[i] < 0 || !ReadCounter(counters->fds[i], &reading)) continue;
+
+        double value = (double)(reading.value - counters->baseline[i][0]);
+        double enabled = (double)(reading.enabled - counters->baseline[i][1]);
+        double running = (double)(reading.running - counters->baseline[i][2]);
+        if (running <= 0.0) continue;  // Never got onto the PMU
+        sample->values[i] = value * (enabled / running);
+    }
+}
+
+#else
+
+bool PerfCountersOpen(PerfCounters *counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) counters->fds[i] = -1;
+    counters->opened = 0;
+    snprintf(counters->error, sizeof(counters->error), "perf_event_open needs Linux");
+    return false;
+}
+
+void PerfCountersClose(PerfCounters *counters) {
+    (void)counters;
+}
+
+void PerfCountersStart(PerfCounters *counters) {
+    (void)counters;
+}
+
+void PerfCountersStop(PerfCounters *counters) {
+    (void)counters;
+}
+
+void PerfCountersRead(const PerfCounters *counters, PerfSample *sample) {
+    (void)counters;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) sample->values[i] = -1.0;
+}
+
+#endif
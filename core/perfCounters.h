@@ -0,0 +1,48 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdbool.h>
+
+// Hardware performance counters of the calling thread through Linux
+// perf_event_open.
+//
+// Every counter is opened as its own event, user space only, so a PMU that
+// cannot schedule them all at once multiplexes them instead of refusing the
+// set. The counts are scaled by time enabled / time running. A counter the
+// CPU or the kernel does not offer (a VM without a virtual PMU, or
+// perf_event_paranoid above 2) is left out. PerfCountersOpen fails only when
+// none can be opened, and then says why in `error`.
+//
+// Elsewhere than Linux PerfCountersOpen always fails.
+
+#define PERF_COUNTER_CYCLES 0
+#define PERF_COUNTER_INSTRUCTIONS 1
+#define PERF_COUNTER_BRANCH_MISSES 2
+#define PERF_COUNTER_L1D_MISSES 3     // L1 data cache read misses
+#define PERF_COUNTER_LLC_MISSES 4     // Last-level cache misses
+#define PERF_COUNTER_COUNT 5
+
+extern const char *perfCounterNames[PERF_COUNTER_COUNT];
+
+typedef struct {
+    int fds[PERF_COUNTER_COUNT];      // -1 when the counter is not available
+    int opened;                       // Counters available
+    unsigned long long baseline[PERF_COUNTER_COUNT][3];  // Count and times at PerfCountersStart
+    char error[128];                  // Why the first failing counter failed
+} PerfCounters;
+
+typedef struct {
+    double values[PERF_COUNTER_COUNT];  // Scaled counts, negative when not available
+} PerfSample;
+
+bool PerfCountersOpen(PerfCounters *counters);
+void PerfCountersClose(PerfCounters *counters);
+
+// Zero the counters and start counting / stop counting
+void PerfCountersStart(PerfCounters *counters);
+void PerfCountersStop(PerfCounters *counters);
+
+// Counts since the last PerfCountersStart
+void PerfCountersRead(const PerfCounters *counters, PerfSample *sample);
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,253 @@
+#include "simThread.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "timing.h"
+#include "trace.h"
+
+#define SIM_SNAPSHOT_FRAMES 7  // Two per snapshot plus `last`
+
+static bool FrameInit(SimFrame *frame, int capacity) {
+    memset(frame, 0, sizeof(*frame));
+    size_t count = capacity > 0 ? (size_t)capacity : 1;
+    frame->crowdX = malloc(sizeof(float) * count);
+    frame->crowdY = malloc(sizeof(float) * count);
+    frame->crowdRotation = malloc(sizeof(float) * count);
+    frame->crowdPaletteOffset = malloc(count);
+    return frame->crowdX && frame->crowdY && frame->crowdRotation && frame->crowdPaletteOffset;
+}
+
+static void FrameFree(SimFrame *frame) {
+    free(frame->crowdX);
+    free(frame->crowdY);
+    free(frame->crowdRotation);
+    free(frame->crowdPaletteOffset);
+    memset(frame, 0, sizeof(*frame));
+}
+
+static void FrameCopy(SimFrame *to, const SimFrame *from) {
+    size_t count = (size_t)from->crowdCount;
+    to->ball = from->ball;
+    to->racket = from->racket;
+    to->crowdCount = from->crowdCount;
+    memcpy(to->crowdX, from->crowdX, sizeof(float) * count);
+    memcpy(to->crowdY, from->crowdY, sizeof(float) * count);
+    memcpy(to->crowdRotation, from->crowdRotation, sizeof(float) * count);
+    memcpy(to->crowdPaletteOffset, from->crowdPaletteOffset, count);
+}
+
+// Capture the simulation state into `last`
+static void CaptureFrame(SimThread *sim) {
+    const BallStore *crowd = &sim->crowd;
+    size_t count = (size_t)crowd->count;
+    sim->last.ball = sim->ball;
+    sim->last.racket = sim->racket;
+    sim->last.crowdCount = crowd->count;
+    memcpy(sim->last.crowdX, crowd->x, sizeof(float) * count);
+    memcpy(sim->last.crowdY, crowd->y, sizeof(float) * count);
+    memcpy(sim->last.crowdRotation, crowd->rotation, sizeof(float) * count);
+    memcpy(sim->last.crowdPaletteOffset, crowd->paletteOffset, count);
+}
+
+static void FillSnapshot(SimThread *sim, SimSnapshot *snapshot, double time, int crowdPairs, double crowdUpdateTime,
+                         double crowdCollideTime) {
+    FrameCopy(&snapshot->previous, &sim->last);
+    CaptureFrame(sim);
+    FrameCopy(&snapshot->current, &sim->last);
+    snapshot->tick = sim->tick;
+    snapshot->time = time;
+    snapshot->score = sim->score;
+    snapshot->crowdPairs = crowdPairs;
+    snapshot->crowdUpdateTime = crowdUpdateTime;
+    snapshot->crowdCollideTime = crowdCollideTime;
+    snapshot->droppedTicks = sim->droppedTicks;
+}
+
+static void ReadInput(SimThread *sim, SimInput *input) {
+    input->path = __atomic_load_n(&sim->input.path, __ATOMIC_RELAXED);
+    input->moving = __atomic_load_n(&sim->input.moving, __ATOMIC_RELAXED);
+    input->racketDirection = __atomic_load_n(&sim->input.racketDirection, __ATOMIC_RELAXED);
+    input->crowdSize = __atomic_load_n(&sim->input.crowdSize, __ATOMIC_RELAXED);
+    input->crowdCollisions = __atomic_load_n(&sim->input.crowdCollisions, __ATOMIC_RELAXED);
+}
+
+// One fixed step of the whole game, then publish it as due at `time`
+static void Tick(SimThread *sim, double time) {
+    TRACE_ZONE("tick");
+    SimInput input;
+    ReadInput(sim, &input);
+
+    int crowdSize = input.crowdSize < 0 ? 0 : input.crowdSize;
+    if (crowdSize > sim->crowdCapacity) crowdSize = sim->crowdCapacity;
+    if (crowdSize != sim->crowd.count) BallStoreResizeCrowd(&sim->crowd, crowdSize);
+
+    MoveRacket(&sim->racket, input.racketDirection * RACKET_SPEED * (float)sim->tickSeconds);
+
+    int crowdPairs = 0;
+    double crowdUpdateTime = 0.0, crowdCollideTime = 0.0;
+    if (input.moving) {
+        if (UpdateBall(&sim->ball, sim->paths[input.path], &sim->racket) & BALL_EVENT_RACKET) {
+            sim->score++;
+        }
+
+        double start = GetHighPrecisionTime();
+        BallStoreUpdate(&sim->crowd, &sim->jobs, &sim->racket);
+        double updated = GetHighPrecisionTime();
+        if (input.crowdCollisions) crowdPairs = BallStoreCollide(&sim->crowd, &sim->crowdHash, &sim->jobs, NULL, 0, NULL);
+        crowdUpdateTime = updated - start;
+        crowdCollideTime = GetHighPrecisionTime() - updated;
+    }
+    sim->tick++;
+
+    TRACE_BEGIN(publish, "publish");
+    FillSnapshot(sim, &sim->snapshots[TripleBufferWriteSlot(&sim->buffer)], time, crowdPairs, crowdUpdateTime, crowdCollideTime);
+    TripleBufferPublish(&sim->buffer);
+    TRACE_END(publish);
+}
+
+static void *SimMain(void *argument) {
+    SimThread *sim = argument;
+    TraceThreadName("sim");
+    double next = GetHighPrecisionTime() + sim->tickSeconds;
+    while (!__atomic_load_n(&sim->quit, __ATOMIC_ACQUIRE)) {
+        SleepUntilTime(next);
+
+        // Too far behind to catch up: drop the backlog and restart the
+        // schedule from now
+        double late = GetHighPrecisionTime() - next;
+        if (late > SIM_MAX_CATCH_UP * sim->tickSeconds) {
+            long long dropped = (long long)(late / sim->tickSeconds);
+            sim->droppedTicks += dropped;
+            next += dropped * sim->tickSeconds;
+        }
+
+        Tick(sim, next);
+        next += sim->tickSeconds;
+    }
+    return NULL;
+}
+
+// Everything SimThreadStart allocates; the job system only when its
+// threads were started
+static void FreeState(SimThread *sim, bool jobs) {
+    for (int i = 0; i < 3; i++) {
+        FrameFree(&sim->snapshots[i].previous);
+        FrameFree(&sim->snapshots[i].current);
+    }
+    FrameFree(&sim->last);
+    if (jobs) JobSystemFree(&sim->jobs);
+    SpatialHashFree(&sim->crowdHash);
+    BallStoreFree(&sim->crowd);
+}
+
+bool SimThreadStart(SimThread *sim, const PathFunction paths[PATH_COUNT], int crowdCapacity, int workers) {
+    memset(sim, 0, sizeof(*sim));
+    sim->paths = paths;
+    sim->crowdCapacity = crowdCapacity;
+    sim->tickSeconds = 1.0 / SIM_TICK_RATE;
+    sim->input = (SimInput){PATH_STRAIGHT, false, 0, 0, false};
+    InitBall(&sim->ball);
+    InitRacket(&sim->racket);
+
+    // sim is zeroed, so the frames, store and hash can all be freed whether
+    // or not their Init ran
+    bool jobs = BallStoreInit(&sim->crowd, crowdCapacity) &&
+                SpatialHashInit(&sim->crowdHash, 2.0f * BALL_RADIUS) &&
+                JobSystemInit(&sim->jobs, workers);
+    bool ok = jobs && FrameInit(&sim->last, crowdCapacity);
+    for (int i = 0; i < 3; i++) {
+        ok = ok && FrameInit(&sim->snapshots[i].previous, crowdCapacity) &&
+             FrameInit(&sim->snapshots[i].current, crowdCapacity);
+    }
+    if (!ok) {
+        FreeState(sim, jobs);
+        return false;
+    }
+
+    // Every slot starts with the initial state, so the renderer has
+    // something to draw before the first tick
+    TripleBufferInit(&sim->buffer);
+    double now = GetHighPrecisionTime();
+    CaptureFrame(sim);
+    for (int i = 0; i < 3; i++) {
+        FillSnapshot(sim, &sim->snapshots[i], now, 0, 0.0, 0.0);
+    }
+    if (pthread_create(&sim->thread, NULL, SimMain, sim) != 0) {
+        FreeState(sim, true);
+        return false;
+    }
+    sim->running = true;
+    return true;
+}
+
+void SimThreadStop(SimThread *sim) {
+    if (!sim->running) return;
+    __atomic_store_n(&sim->quit, 1, __ATOMIC_RELEASE);
+    pthread_join(sim->thread, NULL);
+    sim->running = false;
+    FreeState(sim, true);
+}
+
+void SimThreadSetInput(SimThread *sim, const SimInput *input) {
+    __atomic_store_n(&sim->input.path, input->path, __ATOMIC_RELAXED);
+    __atomic_store_n(&sim->input.moving, input->moving, __ATOMIC_RELAXED);
+    __atomic_store_n(&sim->input.racketDirection, input->racketDirection, __ATOMIC_RELAXED);
+    __atomic_store_n(&sim->input.crowdSize, input->crowdSize, __ATOMIC_RELAXED);
+    __atomic_store_n(&sim->input.crowdCollisions, input->crowdCollisions, __ATOMIC_RELAXED);
+}
+
+const SimSnapshot *SimThreadLatest(SimThread *sim) {
+    TripleBufferAcquire(&sim->buffer);
+    return &sim->snapshots[TripleBufferReadSlot(&sim->buffer)];
+}
+
+// Blend a position that may have wrapped from one screen edge to the other
+// between the ticks; a jump that large is a wrap, so it is not blended
+static float LerpPosition(float from, float to, float alpha) {
+    if (fabsf(to - from) > SCREEN_WIDTH / 2) return to;
+    return from + (to - from) * alpha;
+}
+
+// Blend angles in degrees the short way round
+static float LerpAngle(float from, float to, float alpha) {
+    float delta = fmodf(to - from, 360.0f);
+    if (delta > 180.0f) delta -= 360.0f;
+    if (delta < -180.0f) delta += 360.0f;
+    return from + delta * alpha;
+}
+
+bool SimInterpolate(const SimSnapshot *snapshot, double time, Ball *ball, Racket *racket, BallStore *crowd) {
+    const SimFrame *previous = &snapshot->previous, *current = &snapshot->current;
+
+    // The frame shows the world one tick ago: previous at snapshot->time,
+    // current one tick later
+    float alpha = (float)((time - snapshot->time) * SIM_TICK_RATE);
+    if (alpha < 0.0f) alpha = 0.0f;
+    if (alpha > 1.0f) alpha = 1.0f;
+
+    *ball = current->ball;
+    ball->position.x = LerpPosition(previous->ball.position.x, current->ball.position.x, alpha);
+    ball->position.y = LerpPosition(previous->ball.position.y, current->ball.position.y, alpha);
+    ball->rotation = LerpAngle(previous->ball.rotation, current->ball.rotation, alpha);
+    *racket = current->racket;
+    racket->y = previous->racket.y + (current->racket.y - previous->racket.y) * alpha;
+
+    if (!BallStoreReserve(crowd, current->crowdCount)) return false;
+    crowd->count = current->crowdCount;
+    // Balls are only ever added or removed at the end, so index i is the
+    // same ball in both ticks while it exists in both
+    int blended = previous->crowdCount < current->crowdCount ? previous->crowdCount : current->crowdCount;
+    for (int i = 0; i < blended; i++) {
+        crowd->x[i] = LerpPosition(previous->crowdX[i], current->crowdX[i], alpha);
+        crowd->y[i] = LerpPosition(previous->crowdY[i], current->crowdY[i], alpha);
+        float rotation = LerpAngle(previous->crowdRotation[i], current->crowdRotation[i], alpha);
+        crowd->rotation[i] = rotation < 0.0f ? rotation + 360.0f : rotation;
+    }
+    for (int i = blended; i < current->crowdCount; i++) {
+        crowd->x[i] = current->crowdX[i];
+        crowd->y[i] = current->crowdY[i];
+        crowd->rotation[i] = current->crowdRotation[i];
+    }
+    memcpy(crowd->paletteOffset, current->crowdPaletteOffset, (size_t)current->crowdCount);
+    return true;
+}
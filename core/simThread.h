@@ -0,0 +1,111 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include <stdbool.h>
+#include <pthread.h>
+#include "ball.h"
+#include "ballStore.h"
+#include "jobSystem.h"
+#include "paths.h"
+#include "spatialHash.h"
+#include "tripleBuffer.h"
+
+// Fixed-timestep game simulation on its own thread.
+//
+// The thread owns the player ball, the racket, the score and the crowd, and
+// steps them SIM_TICK_RATE times per second of wall time no matter how fast
+// the window draws: a ball moves velocity in t per tick and the racket
+// RACKET_SPEED / SIM_TICK_RATE pixels. Ticks run on a schedule; when a tick
+// is late the next ones run back to back to catch up, up to SIM_MAX_CATCH_UP
+// of them, after which the simulation drops the time rather than spiral.
+//
+// After every tick the drawable state goes through a TripleBuffer, so the
+// render thread never waits for a tick and a tick never waits for a frame.
+// Each snapshot carries the last two ticks; the renderer draws one tick in
+// the past, blending the two by where the frame falls between them
+// (SimInterpolate), so motion stays smooth when the frame rate and the tick
+// rate differ.
+//
+// Input goes the other way as plain values the thread reads at the start of
+// each tick.
+
+#define SIM_TICK_RATE 60      // Ticks per second, the demos' old frame rate
+#define SIM_MAX_CATCH_UP 5    // Late ticks run back to back before dropping time
+
+typedef struct {
+    int path;                 // PATH_* id of the player ball
+    bool moving;              // Balls advance
+    int racketDirection;      // -1 up, 0 still, 1 down
+    int crowdSize;            // Clamped to the crowd capacity
+    bool crowdCollisions;     // Ball-ball collisions in the crowd
+} SimInput;
+
+// Drawable state after one tick
+typedef struct {
+    Ball ball;
+    Racket racket;
+    int crowdCount;
+    float *crowdX;
+    float *crowdY;
+    float *crowdRotation;
+    unsigned char *crowdPaletteOffset;
+} SimFrame;
+
+typedef struct {
+    SimFrame previous;        // Tick - 1
+    SimFrame current;
+    long long tick;
+    double time;              // Scheduled time of `current` (GetHighPrecisionTime)
+    int score;
+    int crowdPairs;           // Colliding pairs in the last tick
+    double crowdUpdateTime;   // Seconds spent updating the crowd in the last tick
+    double crowdCollideTime;  // Seconds spent on crowd collisions in the last tick
+    long long droppedTicks;   // Ticks skipped after falling too far behind
+} SimSnapshot;
+
+typedef struct {
+    // Shared
+    TripleBuffer buffer;
+    SimSnapshot snapshots[3];
+    SimInput input;           // Each field read and written atomically
+    int quit;
+    bool running;             // Thread started; SimThreadStop does nothing otherwise
+    pthread_t thread;
+
+    // Simulation thread only
+    const PathFunction *paths;
+    int crowdCapacity;
+    double tickSeconds;
+    Ball ball;
+    Racket racket;
+    int score;
+    BallStore crowd;
+    SpatialHash crowdHash;
+    JobSystem jobs;
+    SimFrame last;            // Copy of the last published tick
+    long long tick;
+    long long droppedTicks;
+} SimThread;
+
+// Start the simulation with the player ball on `paths` (pathFunctions or
+// pathFunctionsAsm), room for `crowdCapacity` crowd balls and a job system
+// of `workers` for the crowd (0 = one per CPU). The SimThread must stay at
+// the same address until SimThreadStop. On failure nothing is left
+// allocated and SimThreadStop is a no-op.
+bool SimThreadStart(SimThread *sim, const PathFunction paths[PATH_COUNT], int crowdCapacity, int workers);
+void SimThreadStop(SimThread *sim);
+
+// Render thread: hand new input to the simulation
+void SimThreadSetInput(SimThread *sim, const SimInput *input);
+
+// Render thread: the newest snapshot, valid until the next call
+const SimSnapshot *SimThreadLatest(SimThread *sim);
+
+// Blend the two ticks of `snapshot` for a frame drawn at `time`: the ball
+// and racket positions, rotations and the crowd. `crowd` is a draw-only
+// view: its positions, rotations, palette offsets and count are written but
+// its handles are not kept up to date. Returns false when the view cannot
+// grow.
+bool SimInterpolate(const SimSnapshot *snapshot, double time, Ball *ball, Racket *racket, BallStore *crowd);
+
+#endif // SIM_THREAD_H
@@ -0,0 +1,265 @@
+#include "softRaster.h"
+#include <math.h>
+#include <stdlib.h>
+#include "cpuDispatch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SOFT_RASTER_X86 1
+#endif
+
+#define SOFT_DEG_TO_RAD 0.017453292519943295f
+
+const unsigned int softBallPalette[BALL_MAX_COLORS] = {
+    SOFT_RGBA(230, 41, 55, 255),   // RED
+    SOFT_RGBA(255, 161, 0, 255),   // ORANGE
+    SOFT_RGBA(253, 249, 0, 255),   // YELLOW
+    SOFT_RGBA(0, 228, 48, 255),    // GREEN
+    SOFT_RGBA(0, 121, 241, 255),   // BLUE
+    SOFT_RGBA(200, 122, 255, 255), // PURPLE
+};
+
+bool FramebufferInit(Framebuffer *framebuffer, int width, int height) {
+    framebuffer->width = width;
+    framebuffer->height = height;
+    framebuffer->pixels = malloc(sizeof(unsigned int) * (size_t)width * (size_t)height);
+    return framebuffer->pixels != NULL;
+}
+
+void FramebufferFree(Framebuffer *framebuffer) {
+    free(framebuffer->pixels);
+    framebuffer->pixels = NULL;
+    framebuffer->width = 0;
+    framebuffer->height = 0;
+}
+
+void FramebufferClear(Framebuffer *framebuffer, unsigned int color) {
+    size_t count = (size_t)framebuffer->width * (size_t)framebuffer->height;
+    for (size_t i = 0; i < count; i++) {
+        framebuffer->pixels[i] = color;
+    }
+}
+
+void RasterBallInit(RasterBall *ball, float centerX, float centerY, float radius, float rotation,
+                    const unsigned int colors[BALL_MAX_COLORS]) {
+    ball->centerX = centerX;
+    ball->centerY = centerY;
+    ball->radius = radius;
+    for (int k = 0; k < SOFT_STRIPE_LINES; k++) {
+        float angle = (rotation + k * 360.0f / BALL_MAX_COLORS) * SOFT_DEG_TO_RAD;
+        ball->lineCos[k] = cosf(angle);
+        ball->lineSin[k] = sinf(angle);
+    }
+    for (int k = 0; k < BALL_MAX_COLORS; k++) {
+        ball->colors[k] = colors[k];
+    }
+    for (int code = 0; code < SOFT_STRIPE_CODES; code++) {
+        int sum = 0;
+        for (int k = 1; k < SOFT_STRIPE_LINES; k++) {
+            sum += (code >> k) & 1;
+        }
+        ball->codeColors[code] = colors[(code & 1) ? sum : BALL_MAX_COLORS - 1 - sum];
+    }
+}
+
+// Stripe colour of the pixel centre at (dx, dy) from the ball centre
+static unsigned int StripeColor(const RasterBall *ball, float dx, float dy) {
+    int code = 0;
+    for (int k = 0; k < SOFT_STRIPE_LINES; k++) {
+        code |= (dy * ball->lineCos[k] - dx * ball->lineSin[k] > 0.0f) << k;
+    }
+    return ball->codeColors[code];
+}
+
+// src over dst with coverage in [0, 1]
+static unsigned int BlendOver(unsigned int dst, unsigned int src, float coverage) {
+    unsigned int a = (unsigned int)(coverage * 256.0f);
+    unsigned int rb = ((src & 0x00ff00ffu) * a + (dst & 0x00ff00ffu) * (256 - a)) >> 8;
+    unsigned int ga = ((src >> 8) & 0x00ff00ffu) * a + ((dst >> 8) & 0x00ff00ffu) * (256 - a);
+    return (rb & 0x00ff00ffu) | (ga & 0xff00ff00u);
+}
+
+void SoftRasterSpanScalar(unsigned int *pixels, int count, float dx, float dy, const RasterBall *ball) {
+    for (int i = 0; i < count; i++) {
+        pixels[i] = StripeColor(ball, dx + i, dy);
+    }
+}
+
+#ifdef SOFT_RASTER_X86
+
+__attribute__((target("sse2")))
+void SoftRasterSpanSSE(unsigned int *pixels, int count, float dx, float dy, const RasterBall *ball) {
+    __m128 rowTerm[SOFT_STRIPE_LINES], lineSin[SOFT_STRIPE_LINES];
+    __m128i colorFirst[SOFT_STRIPE_LINES], colorSecond[SOFT_STRIPE_LINES];
+    for (int k = 0; k < SOFT_STRIPE_LINES; k++) {
+        rowTerm[k] = _mm_set1_ps(dy * ball->lineCos[k]);
+        lineSin[k] = _mm_set1_ps(ball->lineSin[k]);
+        colorFirst[k] = _mm_set1_epi32((int)ball->colors[k]);
+        colorSecond[k] = _mm_set1_epi32((int)ball->colors[BALL_MAX_COLORS - 1 - k]);
+    }
+
+    __m128 x = _mm_add_ps(_mm_set1_ps(dx), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+    const __m128 zero = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // Count the lines the pixel is past; masks are -1, so subtract
+        __m128i sum = _mm_setzero_si128();
+        for (int k = 1; k < SOFT_STRIPE_LINES; k++) {
+            __m128 past = _mm_cmpgt_ps(_mm_sub_ps(rowTerm[k], _mm_mul_ps(x, lineSin[k])), zero);
+            sum = _mm_sub_epi32(sum, _mm_castps_si128(past));
+        }
+        __m128i firstHalf = _mm_castps_si128(_mm_cmpgt_ps(_mm_sub_ps(rowTerm[0], _mm_mul_ps(x, lineSin[0])), zero));
+
+        __m128i first = _mm_setzero_si128(), second = _mm_setzero_si128();
+        for (int k = 0; k < SOFT_STRIPE_LINES; k++) {
+            __m128i match = _mm_cmpeq_epi32(sum, _mm_set1_epi32(k));
+            first = _mm_or_si128(first, _mm_and_si128(match, colorFirst[k]));
+            second = _mm_or_si128(second, _mm_and_si128(match, colorSecond[k]));
+        }
+        __m128i color = _mm_or_si128(_mm_and_si128(firstHalf, first), _mm_andnot_si128(firstHalf, second));
+        _mm_storeu_si128((__m128i *)(pixels + i), color);
+        x = _mm_add_ps(x, _mm_set1_ps(4.0f));
+    }
+    SoftRasterSpanScalar(pixels + i, count - i, dx + i, dy, ball);
+}
+
+// The sign code indexes the colour table held in one register (vpermd), and
+// the last partial vector is written with a masked store. The target leaves
+// out FMA so the cross product stays a multiply and a subtract (GCC would
+// fuse them), and pixels on a stripe border round as in the scalar and SSE2
+// kernels.
+__attribute__((target("avx2")))
+void SoftRasterSpanAVX2(unsigned int *pixels, int count, float dx, float dy, const RasterBall *ball) {
+#if SOFT_STRIPE_CODES == 8
+    __m256 rowTerm[SOFT_STRIPE_LINES], lineSin[SOFT_STRIPE_LINES];
+    for (int k = 0; k < SOFT_STRIPE_LINES; k++) {
+        rowTerm[k] = _mm256_set1_ps(dy * ball->lineCos[k]);
+        lineSin[k] = _mm256_set1_ps(ball->lineSin[k]);
+    }
+    const __m256i colors = _mm256_loadu_si256((const __m256i *)ball->codeColors);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    __m256 x = _mm256_add_ps(_mm256_set1_ps(dx), _mm256_cvtepi32_ps(lanes));
+    for (int i = 0; i < count; i += 8) {
+        __m256i code = _mm256_setzero_si256();
+        for (int k = 0; k < SOFT_STRIPE_LINES; k++) {
+            __m256 past = _mm256_cmp_ps(_mm256_sub_ps(rowTerm[k], _mm256_mul_ps(x, lineSin[k])), zero, _CMP_GT_OQ);
+            code = _mm256_or_si256(code, _mm256_and_si256(_mm256_castps_si256(past), _mm256_set1_epi32(1 << k)));
+        }
+        __m256i color = _mm256_permutevar8x32_epi32(colors, code);
+        if (i + 8 <= count) {
+            _mm256_storeu_si256((__m256i *)(pixels + i), color);
+        } else {
+            __m256i keep = _mm256_cmpgt_epi32(_mm256_set1_epi32(count - i), lanes);
+            _mm256_maskstore_epi32((int *)(pixels + i), keep, color);
+        }
+        x = _mm256_add_ps(x, _mm256_set1_ps(8.0f));
+    }
+#else
+    SoftRasterSpanSSE(pixels, count, dx, dy, ball);
+#endif
+}
+
+#else // !SOFT_RASTER_X86
+
+void SoftRasterSpanSSE(unsigned int *pixels, int count, float dx, float dy, const RasterBall *ball) {
+    SoftRasterSpanScalar(pixels, count, dx, dy, ball);
+}
+
+void SoftRasterSpanAVX2(unsigned int *pixels, int count, float dx, float dy, const RasterBall *ball) {
+    SoftRasterSpanScalar(pixels, count, dx, dy, ball);
+}
+
+#endif // SOFT_RASTER_X86
+
+// Blend the edge pixels [x0, x1] of row `y`
+static void DrawEdge(unsigned int *row, int x0, int x1, float dy, const RasterBall *ball) {
+    for (int x = x0; x <= x1; x++) {
+        float dx = x + 0.5f - ball->centerX;
+        float coverage = ball->radius + 0.5f - sqrtf(dx * dx + dy * dy);
+        if (coverage <= 0.0f) continue;
+        unsigned int color = StripeColor(ball, dx, dy);
+        row[x] = coverage >= 1.0f ? color : BlendOver(row[x], color, coverage);
+    }
+}
+
+void SoftDrawRasterBallClipped(Framebuffer *framebuffer, const RasterBall *ball, int clipX0, int clipY0, int clipX1, int clipY1) {
+    const RasterSpanFunction span = GetCpuDispatch()->rasterSpan;
+    const float cx = ball->centerX, cy = ball->centerY, r = ball->radius;
+    const int width = framebuffer->width;
+    if (clipX0 < 0) clipX0 = 0;
+    if (clipY0 < 0) clipY0 = 0;
+    if (clipX1 > width) clipX1 = width;
+    if (clipY1 > framebuffer->height) clipY1 = framebuffer->height;
+    int y0 = (int)floorf(cy - r - 0.5f);
+    int y1 = (int)ceilf(cy + r + 0.5f);
+    if (y0 < clipY0) y0 = clipY0;
+    if (y1 > clipY1 - 1) y1 = clipY1 - 1;
+    const int lastX = clipX1 - 1;
+
+    for (int y = y0; y <= y1; y++) {
+        float dy = y + 0.5f - cy;
+        float outer = (r + 0.5f) * (r + 0.5f) - dy * dy;
+        if (outer <= 0.0f) continue;
+        float halfOuter = sqrtf(outer);
+        int left = (int)ceilf(cx - halfOuter - 0.5f);
+        int right = (int)floorf(cx + halfOuter - 0.5f);
+
+        // Pixel centres within radius - 0.5 are fully covered
+        int innerLeft = right + 1, innerRight = right;
+        float inner = (r - 0.5f) * (r - 0.5f) - dy * dy;
+        if (r > 0.5f && inner > 0.0f) {
+            float halfInner = sqrtf(inner);
+            innerLeft = (int)ceilf(cx - halfInner - 0.5f);
+            innerRight = (int)floorf(cx + halfInner - 0.5f);
+        }
+
+        unsigned int *row = framebuffer->pixels + (size_t)y * (size_t)width;
+        int edgeEnd = innerLeft - 1 < lastX ? innerLeft - 1 : lastX;
+        DrawEdge(row, left < clipX0 ? clipX0 : left, edgeEnd, dy, ball);
+
+        int spanStart = innerLeft < clipX0 ? clipX0 : innerLeft;
+        int spanEnd = innerRight > lastX ? lastX : innerRight;
+        if (spanEnd >= spanStart) {
+            span(row + spanStart, spanEnd - spanStart + 1, spanStart + 0.5f - cx, dy, ball);
+        }
+
+        int edgeStart = innerRight + 1 > clipX0 ? innerRight + 1 : clipX0;
+        DrawEdge(row, edgeStart, right > lastX ? lastX : right, dy, ball);
+    }
+}
+
+void SoftDrawRasterBall(Framebuffer *framebuffer, const RasterBall *ball) {
+    SoftDrawRasterBallClipped(framebuffer, ball, 0, 0, framebuffer->width, framebuffer->height);
+}
+
+void RasterBallFromBall(RasterBall *raster, const Ball *ball, const unsigned int palette[BALL_MAX_COLORS]) {
+    unsigned int colors[BALL_MAX_COLORS];
+    for (int k = 0; k < BALL_MAX_COLORS; k++) {
+        colors[k] = palette[(ball->paletteOffset + k) % BALL_MAX_COLORS];
+    }
+    RasterBallInit(raster, ball->position.x, ball->position.y, BALL_RADIUS, ball->rotation, colors);
+}
+
+void RasterBallFromStore(RasterBall *raster, const BallStore *store, int index, const unsigned int palette[BALL_MAX_COLORS]) {
+    unsigned int colors[BALL_MAX_COLORS];
+    for (int k = 0; k < BALL_MAX_COLORS; k++) {
+        colors[k] = palette[(store->paletteOffset[index] + k) % BALL_MAX_COLORS];
+    }
+    RasterBallInit(raster, store->x[index], store->y[index], BALL_RADIUS, store->rotation[index], colors);
+}
+
+void SoftDrawStripedBall(Framebuffer *framebuffer, const Ball *ball, const unsigned int palette[BALL_MAX_COLORS]) {
+    RasterBall raster;
+    RasterBallFromBall(&raster, ball, palette);
+    SoftDrawRasterBall(framebuffer, &raster);
+}
+
+void SoftDrawBallStore(Framebuffer *framebuffer, const BallStore *store, const unsigned int palette[BALL_MAX_COLORS]) {
+    for (int i = 0; i < store->count; i++) {
+        RasterBall raster;
+        RasterBallFromStore(&raster, store, i, palette);
+        SoftDrawRasterBall(framebuffer, &raster);
+    }
+}
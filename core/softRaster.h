@@ -0,0 +1,91 @@
+#ifndef SOFT_RASTER_H
+#define SOFT_RASTER_H
+
+#include <stdbool.h>
+#include "ball.h"
+#include "ballStore.h"
+
+// CPU software rasterizer for striped balls.
+//
+// Draws straight into an RGBA8 framebuffer (bytes R, G, B, A in memory, the
+// layout raylib's UpdateTexture expects for PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+// so frames can be rendered and measured without a GPU.
+//
+// A ball is one pass over its bounding rows instead of one sector mesh per
+// stripe. The stripe of a pixel comes from the signs of its cross products
+// with the BALL_MAX_COLORS / 2 lines that split the ball into stripes, so
+// there is no atan2: with c_k = (cross with line k > 0), the stripe is
+// c_1 + ... + c_{L-1} when c_0 is set and N - 1 - that sum otherwise. The
+// sign bits form a code that indexes a small per-ball colour table.
+// Rows are split into an interior span, filled by the widest SIMD kernel
+// the CPU supports (see cpuDispatch.h), and a few edge pixels that are
+// blended with an analytic coverage of clamp(radius + 0.5 - distance, 0, 1).
+// Stripe borders inside the ball are not anti-aliased, like DrawCircleSector.
+//
+// Angles follow raylib: degrees, clockwise on screen (y points down), and
+// stripe k starts at rotation + k * 360 / BALL_MAX_COLORS.
+
+#define SOFT_RGBA(r, g, b, a) \
+    ((unsigned int)(r) | (unsigned int)(g) << 8 | (unsigned int)(b) << 16 | (unsigned int)(a) << 24)
+
+#define SOFT_STRIPE_LINES (BALL_MAX_COLORS / 2)
+#define SOFT_STRIPE_CODES (1 << SOFT_STRIPE_LINES)
+
+#if BALL_MAX_COLORS % 2 != 0
+#error "The rasterizer needs an even stripe count"
+#endif
+
+typedef struct {
+    int width;
+    int height;
+    unsigned int *pixels;  // width * height RGBA8 pixels, rows top to bottom
+} Framebuffer;
+
+// One ball prepared for the span kernels
+typedef struct {
+    float centerX, centerY;
+    float radius;
+    float lineCos[SOFT_STRIPE_LINES];   // Direction of each stripe line
+    float lineSin[SOFT_STRIPE_LINES];
+    unsigned int colors[BALL_MAX_COLORS];  // RGBA of stripe k
+    // Colour for each combination of line signs (bit k = past line k), so
+    // kernels can look the stripe up instead of selecting it
+    unsigned int codeColors[SOFT_STRIPE_CODES];
+} RasterBall;
+
+// The palette of ballDraw.c (raylib's RED, ORANGE, YELLOW, GREEN, BLUE,
+// PURPLE) as RGBA8
+extern const unsigned int softBallPalette[BALL_MAX_COLORS];
+
+bool FramebufferInit(Framebuffer *framebuffer, int width, int height);
+void FramebufferFree(Framebuffer *framebuffer);
+void FramebufferClear(Framebuffer *framebuffer, unsigned int color);
+
+// Fill a RasterBall; stripe k gets colors[k]
+void RasterBallInit(RasterBall *ball, float centerX, float centerY, float radius, float rotation,
+                    const unsigned int colors[BALL_MAX_COLORS]);
+
+// Draw a prepared ball, clipped to the framebuffer
+void SoftDrawRasterBall(Framebuffer *framebuffer, const RasterBall *ball);
+
+// Draw a prepared ball into pixels [clipX0, clipX1) x [clipY0, clipY1) only;
+// pixels come out the same as with SoftDrawRasterBall
+void SoftDrawRasterBallClipped(Framebuffer *framebuffer, const RasterBall *ball, int clipX0, int clipY0, int clipX1, int clipY1);
+
+// Prepare a Ball / ball `index` of a BallStore with `palette` (RGBA per
+// palette index, e.g. softBallPalette)
+void RasterBallFromBall(RasterBall *raster, const Ball *ball, const unsigned int palette[BALL_MAX_COLORS]);
+void RasterBallFromStore(RasterBall *raster, const BallStore *store, int index, const unsigned int palette[BALL_MAX_COLORS]);
+
+// Draw a Ball / every ball of a BallStore, one after the other
+void SoftDrawStripedBall(Framebuffer *framebuffer, const Ball *ball, const unsigned int palette[BALL_MAX_COLORS]);
+void SoftDrawBallStore(Framebuffer *framebuffer, const BallStore *store, const unsigned int palette[BALL_MAX_COLORS]);
+
+// Interior span kernels: write `count` pixels whose centres are at
+// (dx + i, dy) relative to the ball centre. Every pixel must lie inside the
+// ball; coverage is not computed. Scalar, 4-wide SSE2 and 8-wide AVX2.
+void SoftRasterSpanScalar(unsigned int *pixels, int count, float dx, float dy, const RasterBall *ball);
+void SoftRasterSpanSSE(unsigned int *pixels, int count, float dx, float dy, const RasterBall *ball);
+void SoftRasterSpanAVX2(unsigned int *pixels, int count, float dx, float dy, const RasterBall *ball);
+
+#endif // SOFT_RASTER_H
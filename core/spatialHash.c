@@ -0,0 +1,299 @@
+#include "spatialHash.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int CellCoord(const SpatialHash *hash, float value) {
+    return (int)floorf(value * hash->inverseCellSize);
+}
+
+static unsigned int BucketOf(const SpatialHash *hash, int cellX, int cellY) {
+    unsigned int h = (unsigned)cellX * 0x8da6b343u ^ (unsigned)cellY * 0xd8163841u;
+    return (h ^ (h >> 16)) & (unsigned)(hash->tableSize - 1);
+}
+
+// First visit of a bucket during the current query
+static bool VisitBucket(SpatialHash *hash, unsigned int bucket) {
+    if (hash->visitStamp[bucket] == hash->stamp) return false;
+    hash->visitStamp[bucket] = hash->stamp;
+    return true;
+}
+
+// Start a query with a fresh stamp; on wrap-around clear the old stamps
+static void BeginQuery(SpatialHash *hash) {
+    if (++hash->stamp == 0) {
+        memset(hash->visitStamp, 0, sizeof(unsigned int) * (size_t)hash->tableCapacity);
+        hash->stamp = 1;
+    }
+}
+
+bool SpatialHashInit(SpatialHash *hash, float cellSize) {
+    memset(hash, 0, sizeof(*hash));
+    hash->cellSize = cellSize;
+    hash->inverseCellSize = 1.0f / cellSize;
+    return true;
+}
+
+void SpatialHashFree(SpatialHash *hash) {
+    free(hash->bucketStart);
+    free(hash->sortedIndex);
+    free(hash->sortedX);
+    free(hash->sortedY);
+    free(hash->circleBucket);
+    free(hash->visitStamp);
+    free(hash->partnerCount);
+    for (int c = 0; c < hash->chunkCapacity; c++) free(hash->chunks[c].partners);
+    free(hash->chunks);
+    memset(hash, 0, sizeof(*hash));
+}
+
+static bool Reserve(SpatialHash *hash, int count) {
+    if (count > hash->capacity) {
+        int capacity = count > hash->capacity * 2 ? count : hash->capacity * 2;
+        free(hash->sortedIndex);
+        free(hash->sortedX);
+        free(hash->sortedY);
+        free(hash->circleBucket);
+        hash->sortedIndex = malloc(sizeof(int) * (size_t)capacity);
+        hash->sortedX = malloc(sizeof(float) * (size_t)capacity);
+        hash->sortedY = malloc(sizeof(float) * (size_t)capacity);
+        hash->circleBucket = malloc(sizeof(unsigned int) * (size_t)capacity);
+        hash->capacity = 0;
+        if (!hash->sortedIndex || !hash->sortedX || !hash->sortedY || !hash->circleBucket) return false;
+        hash->capacity = capacity;
+    }
+
+    // About two buckets per circle keeps unrelated cells from sharing
+    int tableSize = 64;
+    while (tableSize < 2 * count) tableSize *= 2;
+    if (tableSize > hash->tableCapacity) {
+        free(hash->bucketStart);
+        free(hash->visitStamp);
+        hash->bucketStart = malloc(sizeof(int) * ((size_t)tableSize + 1));
+        hash->visitStamp = calloc((size_t)tableSize, sizeof(unsigned int));
+        hash->tableCapacity = 0;
+        if (!hash->bucketStart || !hash->visitStamp) return false;
+        hash->tableCapacity = tableSize;
+        hash->stamp = 0;
+    }
+    hash->tableSize = tableSize;
+    return true;
+}
+
+bool SpatialHashBuild(SpatialHash *hash, const float *x, const float *y, int count) {
+    if (!Reserve(hash, count)) {
+        hash->count = 0;
+        return false;
+    }
+    hash->count = count;
+
+    // Counting sort by bucket: count, prefix sum, scatter
+    int *start = hash->bucketStart;
+    memset(start, 0, sizeof(int) * ((size_t)hash->tableSize + 1));
+    for (int i = 0; i < count; i++) {
+        unsigned int bucket = BucketOf(hash, CellCoord(hash, x[i]), CellCoord(hash, y[i]));
+        hash->circleBucket[i] = bucket;
+        start[bucket + 1]++;
+    }
+    for (int b = 0; b < hash->tableSize; b++) {
+        start[b + 1] += start[b];
+    }
+    for (int i = 0; i < count; i++) {
+        int slot = start[hash->circleBucket[i]]++;
+        hash->sortedIndex[slot] = i;
+        hash->sortedX[slot] = x[i];
+        hash->sortedY[slot] = y[i];
+    }
+
+    // The scatter advanced every start to the next bucket's; shift back
+    for (int b = hash->tableSize; b > 0; b--) {
+        start[b] = start[b - 1];
+    }
+    start[0] = 0;
+    return true;
+}
+
+int SpatialHashForEachPair(SpatialHash *hash, float radius, CollisionPairFunction function, void *context) {
+    const float reach = 4.0f * radius * radius;  // (2r)^2
+    // One ring of neighbour cells when cellSize >= 2r, more for smaller cells
+    const int ring = (int)ceilf(2.0f * radius * hash->inverseCellSize);
+    int pairs = 0;
+
+    // Walk circles in sorted order so neighbouring queries hit warm buckets
+    for (int k = 0; k < hash->count; k++) {
+        int a = hash->sortedIndex[k];
+        float ax = hash->sortedX[k];
+        float ay = hash->sortedY[k];
+        int cellX = CellCoord(hash, ax);
+        int cellY = CellCoord(hash, ay);
+
+        BeginQuery(hash);
+        for (int dy = -ring; dy <= ring; dy++) {
+            for (int dx = -ring; dx <= ring; dx++) {
+                unsigned int bucket = BucketOf(hash, cellX + dx, cellY + dy);
+                if (!VisitBucket(hash, bucket)) continue;
+
+                for (int m = hash->bucketStart[bucket]; m < hash->bucketStart[bucket + 1]; m++) {
+                    int b = hash->sortedIndex[m];
+                    if (b <= a) continue;  // Each pair once
+                    float ex = hash->sortedX[m] - ax;
+                    float ey = hash->sortedY[m] - ay;
+                    if (ex * ex + ey * ey <= reach) {
+                        function(context, a, b);
+                        pairs++;
+                    }
+                }
+            }
+        }
+    }
+    return pairs;
+}
+
+// The visit stamps are shared, so the parallel queries drop repeated buckets
+// by looking back over the neighbour cells instead: the same first visits in
+// the same order, for 8 lookups on average with one ring
+static bool SeenEarlier(const SpatialHash *hash, int cellX, int cellY, int ring, int dx, int dy, unsigned int bucket) {
+    for (int py = -ring; py <= dy; py++) {
+        for (int px = -ring; px <= ring && (py < dy || px < dx); px++) {
+            if (BucketOf(hash, cellX + px, cellY + py) == bucket) return true;
+        }
+    }
+    return false;
+}
+
+typedef struct {
+    SpatialHash *hash;
+    float reach;
+    int ring;
+} PairSearch;
+
+static bool RecordPartner(SpatialHashChunk *chunk, int partner) {
+    if (chunk->count == chunk->capacity) {
+        int capacity = chunk->capacity > 0 ? chunk->capacity * 2 : 1024;
+        int *partners = realloc(chunk->partners, sizeof(int) * (size_t)capacity);
+        if (partners == NULL) return false;
+        chunk->partners = partners;
+        chunk->capacity = capacity;
+    }
+    chunk->partners[chunk->count++] = partner;
+    return true;
+}
+
+static void SearchChunks(void *context, int begin, int end) {
+    const PairSearch *search = context;
+    SpatialHash *hash = search->hash;
+    for (int c = begin; c < end; c++) {
+        SpatialHashChunk *chunk = &hash->chunks[c];
+        int last = (c + 1) * SPATIAL_HASH_PAIR_CHUNK;
+        if (last > hash->count) last = hash->count;
+        chunk->count = 0;
+        chunk->failed = false;
+
+        for (int k = c * SPATIAL_HASH_PAIR_CHUNK; k < last; k++) {
+            int a = hash->sortedIndex[k];
+            float ax = hash->sortedX[k];
+            float ay = hash->sortedY[k];
+            int cellX = CellCoord(hash, ax);
+            int cellY = CellCoord(hash, ay);
+            int found = chunk->count;
+
+            for (int dy = -search->ring; dy <= search->ring; dy++) {
+                for (int dx = -search->ring; dx <= search->ring; dx++) {
+                    unsigned int bucket = BucketOf(hash, cellX + dx, cellY + dy);
+                    if (SeenEarlier(hash, cellX, cellY, search->ring, dx, dy, bucket)) continue;
+
+                    for (int m = hash->bucketStart[bucket]; m < hash->bucketStart[bucket + 1]; m++) {
+                        int b = hash->sortedIndex[m];
+                        if (b <= a) continue;
+                        float ex = hash->sortedX[m] - ax;
+                        float ey = hash->sortedY[m] - ay;
+                        if (ex * ex + ey * ey <= search->reach && !RecordPartner(chunk, b)) {
+                            chunk->failed = true;
+                            return;
+                        }
+                    }
+                }
+            }
+            hash->partnerCount[k] = chunk->count - found;
+        }
+    }
+}
+
+static bool ReserveChunks(SpatialHash *hash, int chunkCount) {
+    if (hash->count > hash->partnerCapacity) {
+        free(hash->partnerCount);
+        hash->partnerCount = malloc(sizeof(int) * (size_t)hash->capacity);
+        hash->partnerCapacity = hash->partnerCount != NULL ? hash->capacity : 0;
+        if (hash->partnerCount == NULL) return false;
+    }
+    if (chunkCount > hash->chunkCapacity) {
+        SpatialHashChunk *chunks = realloc(hash->chunks, sizeof(SpatialHashChunk) * (size_t)chunkCount);
+        if (chunks == NULL) return false;
+        memset(chunks + hash->chunkCapacity, 0, sizeof(SpatialHashChunk) * (size_t)(chunkCount - hash->chunkCapacity));
+        hash->chunks = chunks;
+        hash->chunkCapacity = chunkCount;
+    }
+    return true;
+}
+
+int SpatialHashForEachPairParallel(SpatialHash *hash, JobSystem *jobs, float radius, CollisionPairFunction function,
+                                   void *context) {
+    int chunkCount = (hash->count + SPATIAL_HASH_PAIR_CHUNK - 1) / SPATIAL_HASH_PAIR_CHUNK;
+    if (jobs == NULL || jobs->workerCount == 1 || chunkCount < 2 || !ReserveChunks(hash, chunkCount)) {
+        return SpatialHashForEachPair(hash, radius, function, context);
+    }
+
+    PairSearch search = {hash, 4.0f * radius * radius, (int)ceilf(2.0f * radius * hash->inverseCellSize)};
+    JobSystemParallelFor(jobs, chunkCount, 1, SearchChunks, &search);
+    for (int c = 0; c < chunkCount; c++) {
+        // Nothing has been called yet, so the serial search can start over
+        if (hash->chunks[c].failed) return SpatialHashForEachPair(hash, radius, function, context);
+    }
+
+    // Replay in chunk order, which is the serial order
+    int pairs = 0;
+    for (int c = 0; c < chunkCount; c++) {
+        const SpatialHashChunk *chunk = &hash->chunks[c];
+        int last = (c + 1) * SPATIAL_HASH_PAIR_CHUNK;
+        if (last > hash->count) last = hash->count;
+        int next = 0;
+        for (int k = c * SPATIAL_HASH_PAIR_CHUNK; k < last; k++) {
+            int a = hash->sortedIndex[k];
+            for (int j = 0; j < hash->partnerCount[k]; j++) {
+                function(context, a, chunk->partners[next++]);
+            }
+        }
+        pairs += chunk->count;
+    }
+    return pairs;
+}
+
+int SpatialHashForEachRacketContact(SpatialHash *hash, float radius, const Racket *rackets, int racketCount,
+                                    CollisionPairFunction function, void *context) {
+    int contacts = 0;
+
+    for (int r = 0; r < racketCount; r++) {
+        const Racket *racket = &rackets[r];
+        int minX = CellCoord(hash, racket->x - radius);
+        int maxX = CellCoord(hash, racket->x + racket->width + radius);
+        int minY = CellCoord(hash, racket->y - radius);
+        int maxY = CellCoord(hash, racket->y + racket->height + radius);
+
+        BeginQuery(hash);
+        for (int cellY = minY; cellY <= maxY; cellY++) {
+            for (int cellX = minX; cellX <= maxX; cellX++) {
+                unsigned int bucket = BucketOf(hash, cellX, cellY);
+                if (!VisitBucket(hash, bucket)) continue;
+
+                for (int m = hash->bucketStart[bucket]; m < hash->bucketStart[bucket + 1]; m++) {
+                    Vector2 center = {hash->sortedX[m], hash->sortedY[m]};
+                    if (CircleIntersectsRect(center, radius, racket)) {
+                        function(context, hash->sortedIndex[m], r);
+                        contacts++;
+                    }
+                }
+            }
+        }
+    }
+    return contacts;
+}
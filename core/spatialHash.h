@@ -0,0 +1,83 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <stdbool.h>
+#include "collision.h"
+#include "jobSystem.h"
+
+// Uniform-grid spatial hash broadphase for equal-radius circles.
+//
+// SpatialHashBuild bins every circle into a grid cell of `cellSize` pixels
+// and counting-sorts them by hashed cell, so each bucket's circles are
+// contiguous and their positions are copied next to each other. The grid is
+// unbounded: cell coordinates are hashed into a power-of-two bucket table
+// sized to about twice the circle count, so balls off screen still work.
+//
+// With cellSize >= 2 * radius two overlapping circles are always in the same
+// or adjacent cells, so a pair query looks at 3x3 cells per circle and the
+// cost is linear in the number of circles plus the number of near pairs
+// (smaller cells work too, with a wider neighbourhood).
+// Rebuilding is O(n) and cheaper than incremental updates when most balls
+// move every tick, which they do.
+//
+// SpatialHashForEachPairParallel runs the pair tests on a job system. Each
+// job takes SPATIAL_HASH_PAIR_CHUNK circles of the sorted order and records
+// the pairs it finds. The callbacks then run on the calling thread, chunk by
+// chunk, in the same order SpatialHashForEachPair uses. The results are
+// therefore the same for any number of workers, and the callbacks need not
+// be thread-safe.
+
+#define SPATIAL_HASH_PAIR_CHUNK 256  // Circles per job in SpatialHashForEachPairParallel
+
+// Called once per overlapping pair (a < b) or per circle touching a racket
+typedef void (*CollisionPairFunction)(void *context, int a, int b);
+
+// Pairs one job of SpatialHashForEachPairParallel found
+typedef struct {
+    int *partners;         // Second circle of each pair, in query order
+    int count;
+    int capacity;
+    bool failed;           // Out of memory while recording
+} SpatialHashChunk;
+
+typedef struct {
+    float cellSize;
+    float inverseCellSize;
+    int count;             // Circles in the last build
+    int capacity;          // Allocated circles
+    int tableSize;         // Buckets, a power of two
+    int tableCapacity;
+    int *bucketStart;      // tableSize + 1 offsets into the sorted arrays
+    int *sortedIndex;      // Original circle index, grouped by bucket
+    float *sortedX;        // Positions in the same order
+    float *sortedY;
+    unsigned int *circleBucket;  // Bucket of each circle, by original index
+    unsigned int *visitStamp;    // Per bucket, for visiting each bucket once per query
+    unsigned int stamp;
+    int *partnerCount;     // Pairs per circle in sorted order, for the parallel search
+    int partnerCapacity;
+    SpatialHashChunk *chunks;
+    int chunkCapacity;
+} SpatialHash;
+
+bool SpatialHashInit(SpatialHash *hash, float cellSize);
+void SpatialHashFree(SpatialHash *hash);
+
+// Bin `count` circles at (x[i], y[i]). False when out of memory.
+bool SpatialHashBuild(SpatialHash *hash, const float *x, const float *y, int count);
+
+// Call `function` for every pair of circles of `radius` that overlap.
+// Returns the number of pairs.
+int SpatialHashForEachPair(SpatialHash *hash, float radius, CollisionPairFunction function, void *context);
+
+// SpatialHashForEachPair with the tests spread over `jobs` (NULL or a
+// single worker: the plain version). Same calls in the same order.
+int SpatialHashForEachPairParallel(SpatialHash *hash, JobSystem *jobs, float radius, CollisionPairFunction function,
+                                   void *context);
+
+// Call `function(context, circle, racket)` for every circle of `radius` that
+// overlaps one of the rackets. Returns the number of contacts.
+int SpatialHashForEachRacketContact(SpatialHash *hash, float radius, const Racket *rackets, int racketCount,
+                                    CollisionPairFunction function, void *context);
+
+#endif // SPATIAL_HASH_H
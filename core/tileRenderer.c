@@ -0,0 +1,187 @@
+#include "tileRenderer.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+void TileRendererInit(TileRenderer *renderer) {
+    memset(renderer, 0, sizeof(*renderer));
+}
+
+void TileRendererFree(TileRenderer *renderer) {
+    free(renderer->balls);
+    free(renderer->tileStart);
+    free(renderer->tileBalls);
+    memset(renderer, 0, sizeof(*renderer));
+}
+
+void TileRendererBegin(TileRenderer *renderer) {
+    renderer->ballCount = 0;
+}
+
+static bool ReserveBalls(TileRenderer *renderer, int count) {
+    if (count <= renderer->ballCapacity) return true;
+    int capacity = count > renderer->ballCapacity * 2 ? count : renderer->ballCapacity * 2;
+    RasterBall *balls = realloc(renderer->balls, sizeof(RasterBall) * (size_t)capacity);
+    if (!balls) return false;
+    renderer->balls = balls;
+    renderer->ballCapacity = capacity;
+    return true;
+}
+
+bool TileRendererAddBall(TileRenderer *renderer, const RasterBall *ball) {
+    if (!ReserveBalls(renderer, renderer->ballCount + 1)) return false;
+    renderer->balls[renderer->ballCount++] = *ball;
+    return true;
+}
+
+bool TileRendererAddStripedBall(TileRenderer *renderer, const Ball *ball, const unsigned int palette[BALL_MAX_COLORS]) {
+    if (!ReserveBalls(renderer, renderer->ballCount + 1)) return false;
+    RasterBallFromBall(&renderer->balls[renderer->ballCount++], ball, palette);
+    return true;
+}
+
+typedef struct {
+    RasterBall *balls;
+    const BallStore *store;
+    const unsigned int *palette;
+} PrepareContext;
+
+static void PrepareBalls(void *context, int begin, int end) {
+    const PrepareContext *prepare = context;
+    for (int i = begin; i < end; i++) {
+        RasterBallFromStore(&prepare->balls[i], prepare->store, i, prepare->palette);
+    }
+}
+
+bool TileRendererAddBallStore(TileRenderer *renderer, JobSystem *jobs, const BallStore *store,
+                              const unsigned int palette[BALL_MAX_COLORS]) {
+    TRACE_ZONE("tile prepare");
+    if (!ReserveBalls(renderer, renderer->ballCount + store->count)) return false;
+    PrepareContext context = {renderer->balls + renderer->ballCount, store, palette};
+    if (jobs) {
+        JobSystemParallelFor(jobs, store->count, TILE_PREPARE_GRAIN, PrepareBalls, &context);
+    } else {
+        PrepareBalls(&context, 0, store->count);
+    }
+    renderer->ballCount += store->count;
+    return true;
+}
+
+// Tiles touched by the pixels SoftDrawRasterBall may write for `ball`, or
+// false when the ball is off screen
+static bool BallTiles(const TileRenderer *renderer, const RasterBall *ball, int width, int height,
+                      int *tileX0, int *tileY0, int *tileX1, int *tileY1) {
+    float reach = ball->radius + 0.5f;
+    float left = floorf(ball->centerX - reach), right = ceilf(ball->centerX + reach);
+    float top = floorf(ball->centerY - reach), bottom = ceilf(ball->centerY + reach);
+    if (!(right >= 0.0f && left < width && bottom >= 0.0f && top < height)) return false;
+
+    *tileX0 = left > 0.0f ? (int)left / TILE_SIZE : 0;
+    *tileY0 = top > 0.0f ? (int)top / TILE_SIZE : 0;
+    *tileX1 = right < width - 1 ? (int)right / TILE_SIZE : renderer->tilesX - 1;
+    *tileY1 = bottom < height - 1 ? (int)bottom / TILE_SIZE : renderer->tilesY - 1;
+    return true;
+}
+
+// Counting sort of the balls into per-tile lists, in draw order
+static bool BinBalls(TileRenderer *renderer, int width, int height) {
+    renderer->tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    renderer->tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    int tileCount = renderer->tilesX * renderer->tilesY;
+    if (tileCount + 1 > renderer->tileCapacity) {
+        free(renderer->tileStart);
+        renderer->tileStart = malloc(sizeof(int) * ((size_t)tileCount + 1));
+        renderer->tileCapacity = 0;
+        if (!renderer->tileStart) return false;
+        renderer->tileCapacity = tileCount + 1;
+    }
+    int *tileStart = renderer->tileStart;
+    memset(tileStart, 0, sizeof(int) * ((size_t)tileCount + 1));
+
+    // Count, with tile i's count stored at i + 1
+    for (int i = 0; i < renderer->ballCount; i++) {
+        int tileX0, tileY0, tileX1, tileY1;
+        if (!BallTiles(renderer, &renderer->balls[i], width, height, &tileX0, &tileY0, &tileX1, &tileY1)) continue;
+        for (int tileY = tileY0; tileY <= tileY1; tileY++) {
+            for (int tileX = tileX0; tileX <= tileX1; tileX++) {
+                tileStart[tileY * renderer->tilesX + tileX + 1]++;
+            }
+        }
+    }
+    for (int i = 0; i < tileCount; i++) {
+        tileStart[i + 1] += tileStart[i];
+    }
+
+    int binCount = tileStart[tileCount];
+    if (binCount > renderer->binCapacity) {
+        int capacity = binCount > renderer->binCapacity * 2 ? binCount : renderer->binCapacity * 2;
+        free(renderer->tileBalls);
+        renderer->tileBalls = malloc(sizeof(int) * (size_t)capacity);
+        renderer->binCapacity = 0;
+        if (!renderer->tileBalls) return false;
+        renderer->binCapacity = capacity;
+    }
+
+    // Fill, using tileStart[i] as the write cursor of tile i; afterwards it
+    // has moved to the start of tile i + 1, so shift the offsets back
+    for (int i = 0; i < renderer->ballCount; i++) {
+        int tileX0, tileY0, tileX1, tileY1;
+        if (!BallTiles(renderer, &renderer->balls[i], width, height, &tileX0, &tileY0, &tileX1, &tileY1)) continue;
+        for (int tileY = tileY0; tileY <= tileY1; tileY++) {
+            for (int tileX = tileX0; tileX <= tileX1; tileX++) {
+                renderer->tileBalls[tileStart[tileY * renderer->tilesX + tileX]++] = i;
+            }
+        }
+    }
+    memmove(tileStart + 1, tileStart, sizeof(int) * (size_t)tileCount);
+    tileStart[0] = 0;
+    return true;
+}
+
+typedef struct {
+    const TileRenderer *renderer;
+    Framebuffer *framebuffer;
+    unsigned int clearColor;
+} DrawContext;
+
+static void DrawTiles(void *context, int begin, int end) {
+    const DrawContext *draw = context;
+    const TileRenderer *renderer = draw->renderer;
+    Framebuffer *framebuffer = draw->framebuffer;
+    for (int tile = begin; tile < end; tile++) {
+        int x0 = tile % renderer->tilesX * TILE_SIZE;
+        int y0 = tile / renderer->tilesX * TILE_SIZE;
+        int x1 = x0 + TILE_SIZE < framebuffer->width ? x0 + TILE_SIZE : framebuffer->width;
+        int y1 = y0 + TILE_SIZE < framebuffer->height ? y0 + TILE_SIZE : framebuffer->height;
+
+        for (int y = y0; y < y1; y++) {
+            unsigned int *row = framebuffer->pixels + (size_t)y * (size_t)framebuffer->width;
+            for (int x = x0; x < x1; x++) {
+                row[x] = draw->clearColor;
+            }
+        }
+        for (int i = renderer->tileStart[tile]; i < renderer->tileStart[tile + 1]; i++) {
+            SoftDrawRasterBallClipped(framebuffer, &renderer->balls[renderer->tileBalls[i]], x0, y0, x1, y1);
+        }
+    }
+}
+
+bool TileRendererDraw(TileRenderer *renderer, JobSystem *jobs, Framebuffer *framebuffer, unsigned int clearColor) {
+    TRACE_ZONE("tile draw");
+    TRACE_BEGIN(bin, "tile bin");
+    bool binned = BinBalls(renderer, framebuffer->width, framebuffer->height);
+    TRACE_END(bin);
+    if (!binned) return false;
+
+    // One tile per job: tile costs vary with how many balls land on them,
+    // and stealing evens that out
+    DrawContext context = {renderer, framebuffer, clearColor};
+    int tileCount = renderer->tilesX * renderer->tilesY;
+    if (jobs) {
+        JobSystemParallelFor(jobs, tileCount, 1, DrawTiles, &context);
+    } else {
+        DrawTiles(&context, 0, tileCount);
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef TILE_RENDERER_H
+#define TILE_RENDERER_H
+
+#include <stdbool.h>
+#include "ball.h"
+#include "ballStore.h"
+#include "jobSystem.h"
+#include "softRaster.h"
+
+// Tile-binned, multithreaded front end for the software rasterizer.
+//
+// A frame is a list of balls in draw order. TileRendererDraw splits the
+// framebuffer into TILE_SIZE x TILE_SIZE tiles, bins every ball into the
+// tiles its bounding box touches (a counting sort, so each tile's list
+// keeps the draw order), and then hands whole tiles to the job system.
+// One worker owns a tile from clearing it to drawing its last ball, so the
+// framebuffer needs no locks and the tile stays in that core's cache; the
+// output matches drawing the balls one after the other over the whole
+// frame. Any framebuffer size works; tiles on the right and bottom edges are
+// cut short.
+
+#define TILE_SIZE 64
+#define TILE_PREPARE_GRAIN 1024  // Balls per job when preparing a BallStore
+
+typedef struct {
+    // Balls queued for the next draw, in draw order
+    RasterBall *balls;
+    int ballCount;
+    int ballCapacity;
+
+    // Bins of the last draw: tile i draws tileBalls[tileStart[i] ..
+    // tileStart[i + 1]), tiles in row-major order
+    int tilesX, tilesY;
+    int *tileStart;              // tilesX * tilesY + 1 entries
+    int tileCapacity;
+    int *tileBalls;              // Ball indices
+    int binCapacity;
+} TileRenderer;
+
+void TileRendererInit(TileRenderer *renderer);
+void TileRendererFree(TileRenderer *renderer);
+
+// Empty the ball list for a new frame
+void TileRendererBegin(TileRenderer *renderer);
+
+// Queue balls behind the ones already queued. Return false when out of
+// memory. A BallStore is prepared on the job system when `jobs` is not NULL.
+bool TileRendererAddBall(TileRenderer *renderer, const RasterBall *ball);
+bool TileRendererAddStripedBall(TileRenderer *renderer, const Ball *ball, const unsigned int palette[BALL_MAX_COLORS]);
+bool TileRendererAddBallStore(TileRenderer *renderer, JobSystem *jobs, const BallStore *store,
+                              const unsigned int palette[BALL_MAX_COLORS]);
+
+// Clear the framebuffer to `clearColor` and draw the queued balls on all
+// workers of `jobs` (on the calling thread alone when `jobs` is NULL).
+// Return false when out of memory, leaving the framebuffer untouched.
+bool TileRendererDraw(TileRenderer *renderer, JobSystem *jobs, Framebuffer *framebuffer, unsigned int clearColor);
+
+#endif // TILE_RENDERER_H
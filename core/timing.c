@@ -0,0 +1,36 @@
+#define _POSIX_C_SOURCE 199309L
+#include "timing.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN // Only the performance counter is needed
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+double GetHighPrecisionTime(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER currentTime;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&currentTime);
+    return (double)currentTime.QuadPart / frequency.QuadPart;
+#else
+    struct timespec currentTime;
+    clock_gettime(CLOCK_MONOTONIC, &currentTime);
+    return (double)currentTime.tv_sec + (double)currentTime.tv_nsec / 1e9;
+#endif
+}
+
+void SleepUntilTime(double time) {
+    double remaining = time - GetHighPrecisionTime();
+    if (remaining <= 0.0) return;
+#ifdef _WIN32
+    Sleep((DWORD)(remaining * 1000.0));
+#else
+    struct timespec duration;
+    duration.tv_sec = (time_t)remaining;
+    duration.tv_nsec = (long)((remaining - (double)duration.tv_sec) * 1e9);
+    nanosleep(&duration, NULL);
+#endif
+}
@@ -0,0 +1,12 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+// High-precision monotonic clock in seconds (QueryPerformanceCounter on
+// Windows, CLOCK_MONOTONIC elsewhere). Only differences are meaningful.
+double GetHighPrecisionTime(void);
+
+// Sleep until GetHighPrecisionTime() reaches `time`; returns at once when it
+// already has
+void SleepUntilTime(double time);
+
+#endif // TIMING_H
@@ -0,0 +1,216 @@
+#define _GNU_SOURCE  // CLOCK_MONOTONIC_RAW
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef BALLCORE_NO_TRACE
+
+#include <pthread.h>
+#include <time.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <cpuid.h>
+#define TRACE_X86 1
+#endif
+
+#ifndef CLOCK_MONOTONIC_RAW
+#define CLOCK_MONOTONIC_RAW CLOCK_MONOTONIC
+#endif
+
+#define TRACE_NAME_SIZE 32
+
+typedef struct {
+    const char *name;
+    unsigned long long start;
+    unsigned long long end;
+} TraceEvent;
+
+typedef struct TraceBuffer {
+    TraceEvent *events;
+    int capacity;
+    unsigned long long written;     // Events ever written; the owner stores it with release
+    int tid;
+    char name[TRACE_NAME_SIZE];     // Under registryMutex
+    struct TraceBuffer *next;
+} TraceBuffer;
+
+int traceRecording = 0;
+int traceUseTsc = 0;
+
+static pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+static TraceBuffer *buffers = NULL;  // Every thread that has recorded, newest first
+static int nextTid = 1;
+static int ringSize = TRACE_DEFAULT_EVENTS;
+static unsigned long long startTicks = 0;
+static double ticksPerSecond = 1e9;
+
+static __thread TraceBuffer *threadBuffer = NULL;
+static __thread char threadName[TRACE_NAME_SIZE];
+
+unsigned long long TraceClock(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+// Ring of the calling thread, created on its first event
+static TraceBuffer *ThreadBuffer(void) {
+    if (threadBuffer != NULL) return threadBuffer;
+    pthread_mutex_lock(&registryMutex);
+    TraceBuffer *buffer = calloc(1, sizeof(*buffer));
+    if (buffer != NULL) {
+        buffer->capacity = ringSize;
+        buffer->events = malloc(sizeof(TraceEvent) * (size_t)ringSize);
+        if (buffer->events == NULL) {
+            free(buffer);
+            buffer = NULL;
+        }
+    }
+    if (buffer != NULL) {
+        buffer->tid = nextTid++;
+        memcpy(buffer->name, threadName, sizeof(buffer->name));
+        buffer->next = buffers;
+        buffers = buffer;
+        threadBuffer = buffer;
+    }
+    pthread_mutex_unlock(&registryMutex);
+    return buffer;
+}
+
+void TraceZoneEnd(TraceZone *zone) {
+    if (zone->name == NULL) return;
+    unsigned long long end = TraceNow();
+    if (!__atomic_load_n(&traceRecording, __ATOMIC_ACQUIRE)) return;
+    TraceBuffer *buffer = ThreadBuffer();
+    if (buffer == NULL) return;
+
+    unsigned long long written = buffer->written;
+    buffer->events[written % (unsigned)buffer->capacity] = (TraceEvent){zone->name, zone->start, end};
+    __atomic_store_n(&buffer->written, written + 1, __ATOMIC_RELEASE);
+}
+
+// Use the TSC only when it is invariant (constant rate through frequency
+// and sleep states), and measure its rate against the raw monotonic clock
+static void Calibrate(void) {
+    traceUseTsc = 0;
+    ticksPerSecond = 1e9;
+#ifdef TRACE_X86
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8))) return;
+
+    unsigned long long clock0 = TraceClock(), tsc0 = __builtin_ia32_rdtsc();
+    struct timespec pause = {0, 20000000};
+    nanosleep(&pause, NULL);
+    unsigned long long clock1 = TraceClock(), tsc1 = __builtin_ia32_rdtsc();
+    if (clock1 <= clock0 || tsc1 <= tsc0) return;
+    ticksPerSecond = (double)(tsc1 - tsc0) * 1e9 / (double)(clock1 - clock0);
+    traceUseTsc = 1;
+#endif
+}
+
+bool TraceStart(int eventsPerThread) {
+    TraceStop();
+    pthread_mutex_lock(&registryMutex);
+    ringSize = eventsPerThread > 1 ? eventsPerThread : TRACE_DEFAULT_EVENTS;
+    pthread_mutex_unlock(&registryMutex);
+
+    // Only the first recording picks the clock: no zone can be open before
+    // it, and later ones never switch, so an event never mixes two clocks
+    static bool calibrated = false;
+    if (!calibrated) Calibrate();
+    calibrated = true;
+    startTicks = TraceNow();
+    __atomic_store_n(&traceRecording, 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+void TraceStop(void) {
+    __atomic_store_n(&traceRecording, 0, __ATOMIC_RELEASE);
+}
+
+void TraceThreadName(const char *name) {
+    snprintf(threadName, sizeof(threadName), "%s", name);
+    if (threadBuffer != NULL) {
+        pthread_mutex_lock(&registryMutex);
+        memcpy(threadBuffer->name, threadName, sizeof(threadName));
+        pthread_mutex_unlock(&registryMutex);
+    }
+}
+
+// Zone names are string literals from the code, but quote them properly anyway
+static void WriteJsonString(FILE *out, const char *text) {
+    fputc('"', out);
+    for (; *text != '\0'; text++) {
+        unsigned char c = (unsigned char)*text;
+        if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+        else if (c < 0x20) fprintf(out, "\\u%04x", c);
+        else fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+bool TraceWriteChrome(const char *path) {
+    FILE *out = fopen(path, "w");
+    if (out == NULL) return false;
+
+    double microseconds = 1e6 / ticksPerSecond;
+    bool first = true;
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    pthread_mutex_lock(&registryMutex);
+    for (TraceBuffer *buffer = buffers; buffer != NULL; buffer = buffer->next) {
+        if (buffer->name[0] != '\0') {
+            fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                    first ? "" : ",\n", buffer->tid);
+            WriteJsonString(out, buffer->name);
+            fprintf(out, "}}");
+            first = false;
+        }
+
+        // The oldest slot is skipped when the ring is full: its owner may be
+        // overwriting it with an event that ended just before TraceStop
+        unsigned long long written = __atomic_load_n(&buffer->written, __ATOMIC_ACQUIRE);
+        unsigned long long keep = (unsigned long long)buffer->capacity - 1;
+        unsigned long long begin = written > keep ? written - keep : 0;
+        for (unsigned long long i = begin; i < written; i++) {
+            const TraceEvent *event = &buffer->events[i % (unsigned)buffer->capacity];
+            if (event->start < startTicks) continue;  // From an earlier recording
+            fprintf(out, "%s{\"name\":", first ? "" : ",\n");
+            WriteJsonString(out, event->name);
+            fprintf(out, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", buffer->tid,
+                    (double)(event->start - startTicks) * microseconds,
+                    (double)(event->end - event->start) * microseconds);
+            first = false;
+        }
+    }
+    pthread_mutex_unlock(&registryMutex);
+    fprintf(out, "\n]}\n");
+    return fclose(out) == 0;
+}
+
+#else // BALLCORE_NO_TRACE
+
+bool TraceStart(int eventsPerThread) {
+    (void)eventsPerThread;
+    return false;
+}
+
+void TraceStop(void) {
+}
+
+void TraceThreadName(const char *name) {
+    (void)name;
+}
+
+bool TraceWriteChrome(const char *path) {
+    (void)path;
+    return false;
+}
+
+#endif // BALLCORE_NO_TRACE
+
+const char *TraceStartFromEnvironment(void) {
+    const char *path = getenv("BALLCORE_TRACE");
+    if (path == NULL || path[0] == '\0') return NULL;
+    return TraceStart(TRACE_DEFAULT_EVENTS) ? path : NULL;
+}
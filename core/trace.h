@@ -0,0 +1,92 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Scoped tracing zones with Chrome trace export.
+//
+//   TRACE_ZONE("collide");              // Until the end of the enclosing block
+//   TRACE_BEGIN(draw, "draw"); ... TRACE_END(draw);
+//
+// A zone costs one relaxed load and a branch while nothing is recording.
+// While recording, it reads the clock at both ends and writes one 24-byte
+// event into a ring buffer owned by the calling thread. No locks or shared
+// cache lines are touched, so zones can sit on the job system's workers.
+// Each ring keeps the newest events of its thread.
+//
+// The clock is the TSC when the CPU marks it invariant. It is calibrated
+// against CLOCK_MONOTONIC_RAW for 20 ms in TraceStart. Elsewhere the clock
+// is CLOCK_MONOTONIC_RAW itself, which costs about twice as much per read.
+//
+// TraceWriteChrome writes the recording as Chrome trace JSON for
+// chrome://tracing or ui.perfetto.dev. There is one track per thread, named
+// by TraceThreadName.
+//
+// Building with -DBALLCORE_NO_TRACE (make TRACE=0) removes every zone. The
+// functions below then do nothing.
+
+#define TRACE_DEFAULT_EVENTS 65536   // Ring size per thread
+
+typedef struct {
+    const char *name;                // NULL when the zone is not recorded
+    unsigned long long start;
+} TraceZone;
+
+// Start recording with rings of `eventsPerThread` events. Threads that
+// already have a ring keep its size. Returns false when tracing is
+// compiled out.
+bool TraceStart(int eventsPerThread);
+void TraceStop(void);
+
+// Start recording when BALLCORE_TRACE names an output file, and return the
+// name (NULL otherwise), for TraceWriteChrome at exit
+const char *TraceStartFromEnvironment(void);
+
+// Name the calling thread's track; the name is copied
+void TraceThreadName(const char *name);
+
+// Write the events since the last TraceStart as Chrome trace JSON. Call it
+// after TraceStop: an event still being written is left out.
+bool TraceWriteChrome(const char *path);
+
+#ifndef BALLCORE_NO_TRACE
+
+extern int traceRecording;
+extern int traceUseTsc;
+
+unsigned long long TraceClock(void);
+void TraceZoneEnd(TraceZone *zone);
+
+static inline unsigned long long TraceNow(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (traceUseTsc) return __builtin_ia32_rdtsc();
+#endif
+    return TraceClock();
+}
+
+static inline TraceZone TraceZoneBegin(const char *name) {
+    TraceZone zone = {NULL, 0};
+    if (__atomic_load_n(&traceRecording, __ATOMIC_RELAXED)) {
+        zone.name = name;
+        zone.start = TraceNow();
+    }
+    return zone;
+}
+
+#define TRACE_JOIN2(a, b) a##b
+#define TRACE_JOIN(a, b) TRACE_JOIN2(a, b)
+#define TRACE_ZONE(name) \
+    TraceZone TRACE_JOIN(traceZone, __LINE__) __attribute__((cleanup(TraceZoneEnd))) = TraceZoneBegin(name)
+#define TRACE_BEGIN(zone, name) TraceZone zone = TraceZoneBegin(name)
+#define TRACE_END(zone) TraceZoneEnd(&zone)
+
+#else // BALLCORE_NO_TRACE
+
+#define TRACE_ZONE(name) ((void)0)
+#define TRACE_BEGIN(zone, name) ((void)0)
+#define TRACE_END(zone) ((void)0)
+
+#endif // BALLCORE_NO_TRACE
+
+#endif // TRACE_H
@@ -0,0 +1,30 @@
+#include "tripleBuffer.h"
+
+void TripleBufferInit(TripleBuffer *buffer) {
+    buffer->writeSlot = 0;
+    buffer->shared = 1;
+    buffer->readSlot = 2;
+}
+
+int TripleBufferWriteSlot(const TripleBuffer *buffer) {
+    return buffer->writeSlot;
+}
+
+void TripleBufferPublish(TripleBuffer *buffer) {
+    // Release makes the slot contents visible before the index; acquire
+    // takes over whatever the consumer last wrote to the slot it swapped in
+    unsigned int published = (unsigned)buffer->writeSlot | TRIPLE_BUFFER_FRESH;
+    unsigned int previous = __atomic_exchange_n(&buffer->shared, published, __ATOMIC_ACQ_REL);
+    buffer->writeSlot = (int)(previous & ~TRIPLE_BUFFER_FRESH);
+}
+
+bool TripleBufferAcquire(TripleBuffer *buffer) {
+    if (!(__atomic_load_n(&buffer->shared, __ATOMIC_RELAXED) & TRIPLE_BUFFER_FRESH)) return false;
+    unsigned int previous = __atomic_exchange_n(&buffer->shared, (unsigned)buffer->readSlot, __ATOMIC_ACQ_REL);
+    buffer->readSlot = (int)(previous & ~TRIPLE_BUFFER_FRESH);
+    return true;
+}
+
+int TripleBufferReadSlot(const TripleBuffer *buffer) {
+    return buffer->readSlot;
+}
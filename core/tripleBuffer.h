@@ -0,0 +1,38 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <stdbool.h>
+
+// Lock-free hand-off of the latest value from one producer thread to one
+// consumer thread.
+//
+// Three slots rotate between the roles "being written", "latest published"
+// and "being read". Publishing swaps the write slot with the published one;
+// acquiring swaps the read slot with the published one if something new was
+// published since the last acquire. Neither side ever waits, the producer
+// can publish faster than the consumer reads (old values are dropped), and
+// the consumer always holds one complete value.
+//
+// The slots are owned by the caller; the buffer only hands out indices.
+
+typedef struct {
+    unsigned int shared;  // Published slot index, plus TRIPLE_BUFFER_FRESH
+    int writeSlot;        // Producer's slot
+    int readSlot;         // Consumer's slot
+} TripleBuffer;
+
+#define TRIPLE_BUFFER_FRESH 4u  // Set in `shared` when the consumer has not seen it
+
+// Slot 0 starts as the write slot, 1 as published (not fresh), 2 as read
+void TripleBufferInit(TripleBuffer *buffer);
+
+// Producer: index of the slot to fill, then publish it
+int TripleBufferWriteSlot(const TripleBuffer *buffer);
+void TripleBufferPublish(TripleBuffer *buffer);
+
+// Consumer: take the newest published slot if there is one (returns whether
+// the read slot changed), then read it
+bool TripleBufferAcquire(TripleBuffer *buffer);
+int TripleBufferReadSlot(const TripleBuffer *buffer);
+
+#endif // TRIPLE_BUFFER_H
@@ -0,0 +1,260 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ball.h"
+#include "ballStore.h"
+#include "jobSystem.h"
+#include "paths.h"
+#include "simThread.h"
+#include "spatialHash.h"
+#include "timing.h"
+#include "trace.h"
+
+// The interactionBall game without a window: a crowd of balls on a mix of
+// paths runs for a fixed number of ticks against a racket that sweeps up
+// and down as if an arrow key were held, reversing at the screen edges.
+// Every tick moves the racket, updates the crowd (path stepping, spin,
+// racket and wall bounces, speed-ups and colour rotation) and, with
+// --collisions, bounces the balls off each other, like one SimThread tick.
+//
+// The run is deterministic: the same arguments give the same checksum for
+// any number of workers. BALLCORE_TRACE=file.json also records a Chrome
+// trace of the ticks.
+
+#define PHASE_RACKET 0
+#define PHASE_UPDATE 1
+#define PHASE_COLLIDE 2
+#define PHASE_COUNT 3
+
+#define MIX_MAX_WEIGHT 1000000  // Per path, so the weights sum without overflow
+
+static const char *phaseNames[PHASE_COUNT] = {"racket", "update", "collide"};
+
+typedef struct {
+    int balls;
+    long long ticks;
+    int workers;                 // 0 = one per CPU
+    bool collisions;
+    bool csv;
+    int weights[PATH_COUNT];     // Share of the crowd on each path
+} SimOptions;
+
+typedef struct {
+    double total;                // Seconds over the run
+    double worst;                // Longest single tick
+} PhaseTime;
+
+static void Usage(const char *program) {
+    fprintf(stderr,
+            "usage: %s [--balls N] [--ticks M] [--mix PATH[:WEIGHT],...] [--workers K]\n"
+            "          [--collisions] [--csv]\n"
+            "PATH is one of straight, angular, convex, sinusoidal (default: all, equal weights)\n"
+            "WEIGHT is at most %d per path\n",
+            program, MIX_MAX_WEIGHT);
+}
+
+// "convex:3,sinusoidal" -> weights {0, 0, 3, 1}
+static bool ParseMix(const char *text, int weights[PATH_COUNT]) {
+    memset(weights, 0, sizeof(int) * PATH_COUNT);
+    while (*text != '\0') {
+        size_t length = strcspn(text, ":,");
+        int path = 0;
+        while (path < PATH_COUNT && !(strlen(pathNames[path]) == length && strncmp(text, pathNames[path], length) == 0)) {
+            path++;
+        }
+        if (path == PATH_COUNT) return false;
+        text += length;
+
+        long weight = 1;
+        if (*text == ':') {
+            char *end;
+            weight = strtol(text + 1, &end, 10);
+            if (end == text + 1 || weight < 0 || weight > MIX_MAX_WEIGHT) return false;
+            text = end;
+        }
+        // A path named twice adds up, within the same limit
+        if (weight > MIX_MAX_WEIGHT - weights[path]) return false;
+        weights[path] += (int)weight;
+        if (*text == ',') text++;
+        else if (*text != '\0') return false;
+    }
+    for (int path = 0; path < PATH_COUNT; path++) {
+        if (weights[path] > 0) return true;
+    }
+    return false;
+}
+
+static bool ParseOptions(SimOptions *options, int argc, char **argv) {
+    options->balls = 10000;
+    options->ticks = 1000;
+    options->workers = 0;
+    options->collisions = false;
+    options->csv = false;
+    for (int path = 0; path < PATH_COUNT; path++) options->weights[path] = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--balls") == 0 && i + 1 < argc) {
+            options->balls = atoi(argv[++i]);
+            if (options->balls < 1) return false;
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            options->ticks = atoll(argv[++i]);
+            if (options->ticks < 1) return false;
+        } else if (strcmp(argv[i], "--mix") == 0 && i + 1 < argc) {
+            if (!ParseMix(argv[++i], options->weights)) return false;
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            options->workers = atoi(argv[++i]);
+            if (options->workers < 0) return false;
+        } else if (strcmp(argv[i], "--collisions") == 0) {
+            options->collisions = true;
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            options->csv = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Split the crowd by weight (largest remainders get the leftover balls) and
+// spread each path's share along t on its own, so every path has balls
+// everywhere
+static bool SpawnCrowd(BallStore *store, int balls, const int weights[PATH_COUNT]) {
+    int total = 0, counts[PATH_COUNT], assigned = 0;
+    for (int path = 0; path < PATH_COUNT; path++) total += weights[path];
+    for (int path = 0; path < PATH_COUNT; path++) {
+        counts[path] = (int)((long long)balls * weights[path] / total);
+        assigned += counts[path];
+    }
+    bool extra[PATH_COUNT] = {false};
+    while (assigned < balls) {
+        // Fewer leftovers than weighted paths, so each gets at most one
+        int best = -1;
+        long long bestRemainder = -1;
+        for (int path = 0; path < PATH_COUNT; path++) {
+            long long remainder = (long long)balls * weights[path] % total;
+            if (weights[path] > 0 && !extra[path] && remainder > bestRemainder) {
+                best = path;
+                bestRemainder = remainder;
+            }
+        }
+        extra[best] = true;
+        counts[best]++;
+        assigned++;
+    }
+
+    for (int path = 0; path < PATH_COUNT; path++) {
+        int first = BallStoreSpawn(store, counts[path], path, NULL);
+        if (first < 0) return false;
+        BallStoreSpreadCrowd(store, first, counts[path]);
+    }
+    return true;
+}
+
+// FNV-1a over the bytes of an array
+static unsigned long long Hash(unsigned long long hash, const void *data, size_t bytes) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < bytes; i++) {
+        hash = (hash ^ p[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static unsigned long long Checksum(const BallStore *store, const Racket *racket, long long hits, long long pairs) {
+    size_t count = (size_t)store->count;
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+    hash = Hash(hash, store->x, sizeof(float) * count);
+    hash = Hash(hash, store->y, sizeof(float) * count);
+    hash = Hash(hash, store->t, sizeof(float) * count);
+    hash = Hash(hash, store->velocity, sizeof(float) * count);
+    hash = Hash(hash, store->rotation, sizeof(float) * count);
+    hash = Hash(hash, store->paletteOffset, count);
+    hash = Hash(hash, &racket->y, sizeof(racket->y));
+    hash = Hash(hash, &hits, sizeof(hits));
+    hash = Hash(hash, &pairs, sizeof(pairs));
+    return hash;
+}
+
+int main(int argc, char **argv) {
+    SimOptions options;
+    if (!ParseOptions(&options, argc, argv)) {
+        Usage(argv[0]);
+        return 1;
+    }
+    const char *tracePath = TraceStartFromEnvironment();
+    TraceThreadName("main");
+
+    BallStore crowd;
+    SpatialHash hash;
+    JobSystem jobs;
+    if (!BallStoreInit(&crowd, options.balls) || !SpawnCrowd(&crowd, options.balls, options.weights) ||
+        !SpatialHashInit(&hash, 2.0f * BALL_RADIUS) || !JobSystemInit(&jobs, options.workers)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    Racket racket;
+    InitRacket(&racket);
+
+    PhaseTime phases[PHASE_COUNT] = {{0.0, 0.0}};
+    long long hits = 0, pairs = 0;
+    float racketStep = RACKET_SPEED / SIM_TICK_RATE;
+    double runStart = GetHighPrecisionTime();
+    for (long long tick = 0; tick < options.ticks; tick++) {
+        TRACE_ZONE("tick");
+        double times[PHASE_COUNT + 1];
+        times[PHASE_RACKET] = GetHighPrecisionTime();
+        float before = racket.y;
+        MoveRacket(&racket, racketStep);
+        if (racket.y == before) {
+            racketStep = -racketStep;
+            MoveRacket(&racket, racketStep);
+        }
+
+        times[PHASE_UPDATE] = GetHighPrecisionTime();
+        hits += BallStoreUpdate(&crowd, &jobs, &racket);
+
+        times[PHASE_COLLIDE] = GetHighPrecisionTime();
+        if (options.collisions) pairs += BallStoreCollide(&crowd, &hash, &jobs, NULL, 0, NULL);
+        times[PHASE_COUNT] = GetHighPrecisionTime();
+
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            double elapsed = times[phase + 1] - times[phase];
+            phases[phase].total += elapsed;
+            if (elapsed > phases[phase].worst) phases[phase].worst = elapsed;
+        }
+    }
+    double wall = GetHighPrecisionTime() - runStart;
+    if (tracePath != NULL) {
+        TraceStop();
+        if (!TraceWriteChrome(tracePath)) fprintf(stderr, "cannot write %s\n", tracePath);
+    }
+
+    double ballTicks = (double)options.balls * (double)options.ticks;
+    unsigned long long checksum = Checksum(&crowd, &racket, hits, pairs);
+    if (options.csv) {
+        printf("balls,ticks,workers,collisions,wall_s,ball_ticks_per_s");
+        for (int phase = 0; phase < PHASE_COUNT; phase++) printf(",%s_s,%s_worst_us", phaseNames[phase], phaseNames[phase]);
+        printf(",racket_hits,pairs,checksum\n");
+        printf("%d,%lld,%d,%d,%.6f,%.0f", options.balls, options.ticks, jobs.workerCount, options.collisions,
+               wall, ballTicks / wall);
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            printf(",%.6f,%.1f", phases[phase].total, phases[phase].worst * 1e6);
+        }
+        printf(",%lld,%lld,%016llx\n", hits, pairs, checksum);
+    } else {
+        printf("%d balls x %lld ticks, workers %d, collisions %s\n", options.balls, options.ticks,
+               jobs.workerCount, options.collisions ? "on" : "off");
+        printf("%-10s %10.3f ms   %.3g ball-ticks/s\n", "wall", wall * 1e3, ballTicks / wall);
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            printf("%-10s %10.3f ms   %8.2f us/tick   worst %8.2f us   %5.1f%%\n", phaseNames[phase],
+                   phases[phase].total * 1e3, phases[phase].total * 1e6 / options.ticks,
+                   phases[phase].worst * 1e6, 100.0 * phases[phase].total / wall);
+        }
+        printf("racket hits %lld, ball pairs %lld\n", hits, pairs);
+        printf("checksum %016llx\n", checksum);
+    }
+
+    JobSystemFree(&jobs);
+    SpatialHashFree(&hash);
+    BallStoreFree(&crowd);
+    return 0;
+}
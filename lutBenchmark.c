@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include "benchHarness.h"
+#include "pathBatch.h"
+#include "pathArcLength.h"
+#include "pathLut.h"
+#include "paths.h"
+
+#define SAMPLE_COUNT 1000
+#define ERROR_SAMPLES 100003 // Odd count so samples fall between table points
+
+static float ts[SAMPLE_COUNT], xs[SAMPLE_COUNT], ys[SAMPLE_COUNT];
+static float distances[SAMPLE_COUNT], arcTs[SAMPLE_COUNT];
+
+static const int resolutions[] = {16, 64, 256, 1024, 4096};
+#define RESOLUTION_COUNT ((int)(sizeof(resolutions) / sizeof(resolutions[0])))
+
+// Direct evaluation through the scalar path functions of core/paths.c;
+// `context` points at the PATH_* id
+static void RunDirect(void *context, long long iterations) {
+    PathFunction function = pathFunctions[*(const int *)context];
+    for (long long i = 0; i < iterations; i++) {
+        for (int j = 0; j < SAMPLE_COUNT; j++) {
+            Vector2 position = function(ts[j]);
+            BenchDoNotOptimize(position.x);
+            BenchDoNotOptimize(position.y);
+        }
+    }
+}
+
+static void RunBatch(void *context, long long iterations) {
+    int path = *(const int *)context;
+    for (long long i = 0; i < iterations; i++) {
+        CalculatePathBatch(path, ts, xs, ys, SAMPLE_COUNT);
+        BenchClobberMemory();
+    }
+}
+
+typedef struct {
+    const PathLut *lut;
+    int mode;
+} LutContext;
+
+static void RunLut(void *context, long long iterations) {
+    const LutContext *lut = context;
+    for (long long i = 0; i < iterations; i++) {
+        PathLutSampleBatch(lut->lut, lut->mode, ts, xs, ys, SAMPLE_COUNT);
+        BenchClobberMemory();
+    }
+}
+
+// Constant speed: distance -> t through the arc-length table
+static void RunArcLookup(void *context, long long iterations) {
+    const PathArcTable *arc = context;
+    for (long long i = 0; i < iterations; i++) {
+        PathArcTableTBatch(arc, distances, arcTs, SAMPLE_COUNT);
+        BenchClobberMemory();
+    }
+}
+
+// ... then the batch path evaluation at that t
+static void RunArcPath(void *context, long long iterations) {
+    const PathArcTable *arc = context;
+    for (long long i = 0; i < iterations; i++) {
+        PathArcTableTBatch(arc, distances, arcTs, SAMPLE_COUNT);
+        CalculatePathBatch(arc->path, arcTs, xs, ys, SAMPLE_COUNT);
+        BenchClobberMemory();
+    }
+}
+
+static void BenchmarkPath(BenchConfig *config, int path) {
+    const char *name = pathNames[path];
+    char variant[32];
+
+    BenchRun(config, name, "direct", RunDirect, &path, SAMPLE_COUNT);
+    BenchRun(config, name, "batch", RunBatch, &path, SAMPLE_COUNT);
+
+    for (int r = 0; r < RESOLUTION_COUNT; r++) {
+        PathLut lut;
+        if (!PathLutInit(&lut, path, resolutions[r])) {
+            fprintf(stderr, "%s: LUT %d allocation failed\n", name, resolutions[r]);
+            continue;
+        }
+        for (int mode = PATH_LUT_LINEAR; mode <= PATH_LUT_CUBIC; mode++) {
+            LutContext context = {&lut, mode};
+            snprintf(variant, sizeof(variant), "lut%d-%s", resolutions[r], mode == PATH_LUT_CUBIC ? "cubic" : "linear");
+            BenchRun(config, name, variant, RunLut, &context, SAMPLE_COUNT);
+        }
+        PathLutFree(&lut);
+    }
+
+    for (int r = 0; r < RESOLUTION_COUNT; r++) {
+        PathArcTable arc;
+        if (!PathArcTableInit(&arc, path, resolutions[r])) {
+            fprintf(stderr, "%s: arc %d allocation failed\n", name, resolutions[r]);
+            continue;
+        }
+        for (int i = 0; i < SAMPLE_COUNT; i++) {
+            distances[i] = arc.length * i / SAMPLE_COUNT;
+        }
+        snprintf(variant, sizeof(variant), "arc%d-lookup", resolutions[r]);
+        BenchRun(config, name, variant, RunArcLookup, &arc, SAMPLE_COUNT);
+        snprintf(variant, sizeof(variant), "arc%d-batch", resolutions[r]);
+        BenchRun(config, name, variant, RunArcPath, &arc, SAMPLE_COUNT);
+        PathArcTableFree(&arc);
+    }
+}
+
+// Table sizes and errors go with the timings in the human-readable report
+static void ReportAccuracy(int path) {
+    for (int r = 0; r < RESOLUTION_COUNT; r++) {
+        PathLut lut;
+        if (!PathLutInit(&lut, path, resolutions[r])) continue;
+        for (int mode = PATH_LUT_LINEAR; mode <= PATH_LUT_CUBIC; mode++) {
+            printf("%-12s lut%d-%-6s %6zu bytes  max error %.6f px\n", pathNames[path], resolutions[r],
+                   mode == PATH_LUT_CUBIC ? "cubic" : "linear", PathLutBytes(&lut),
+                   PathLutMaxError(&lut, mode, ERROR_SAMPLES));
+        }
+        PathLutFree(&lut);
+    }
+    for (int r = 0; r < RESOLUTION_COUNT; r++) {
+        PathArcTable arc;
+        if (!PathArcTableInit(&arc, path, resolutions[r])) continue;
+        printf("%-12s arc%-10d %6zu bytes  max error %.6f px of %.1f\n", pathNames[path], resolutions[r],
+               PathArcTableBytes(&arc), PathArcTableMaxError(&arc, ERROR_SAMPLES), arc.length);
+        PathArcTableFree(&arc);
+    }
+}
+
+int main(int argc, char **argv) {
+    BenchConfig config;
+    BenchConfigDefaults(&config);
+    if (!BenchParseArgs(&config, argc, argv)) {
+        fprintf(stderr, "usage: %s [--csv | --json] [--quick] [--counters] [--trials N] [--label TEXT]\n", argv[0]);
+        return 1;
+    }
+
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        ts[i] = (float)i / SAMPLE_COUNT;
+    }
+
+    BenchReportBegin(&config);
+    BenchmarkPath(&config, PATH_CONVEX);
+    BenchmarkPath(&config, PATH_SINUSOIDAL);
+    BenchReportEnd(&config);
+
+    if (config.format == BENCH_FORMAT_TEXT) {
+        ReportAccuracy(PATH_CONVEX);
+        ReportAccuracy(PATH_SINUSOIDAL);
+    }
+    return 0;
+}
@@ -1,81 +1,202 @@
-#include "raylib.h"
-#include <math.h>
 #include <stdio.h>
-#include <time.h>  // For benchmarking
+#include "ball.h"
+#include "benchHarness.h"
+#include "cpuDispatch.h"
+#include "pathBatch.h"
+#include "pathFixed.h"
+#include "pathJit.h"
+#include "pathSpec.h"
+#include "pathStepper.h"
+#include "paths.h"
+#include "timing.h"
 
-#define SCREEN_WIDTH 800
-#define SCREEN_HEIGHT 600
-#define BALL_RADIUS 30
+#define SAMPLE_COUNT 1000  // t = 0, 0.001, ..., 0.999
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+static float sampleT[SAMPLE_COUNT];
+static float sampleX[SAMPLE_COUNT], sampleY[SAMPLE_COUNT];
+static unsigned char sampleHits[SAMPLE_COUNT];
+static Fixed fixedT[SAMPLE_COUNT], fixedX[SAMPLE_COUNT], fixedY[SAMPLE_COUNT];
 
-Vector2 CalculateStraightPath(float t) {
-    return (Vector2){t * SCREEN_WIDTH, SCREEN_HEIGHT / 2};
+// Scalar path functions; `context` points at the PathFunction to run and
+// every result goes through the sink so the loop cannot be deleted
+static void RunPathFunction(void *context, long long iterations) {
+    PathFunction function = *(const PathFunction *)context;
+    for (long long i = 0; i < iterations; i++) {
+        for (int j = 0; j < SAMPLE_COUNT; j++) {
+            Vector2 position = function(sampleT[j]);
+            BenchDoNotOptimize(position.x);
+            BenchDoNotOptimize(position.y);
+        }
+    }
+}
+
+typedef struct {
+    int path;
+    const CpuDispatch *dispatch;
+} BatchContext;
+
+// Batched SoA kernels of one dispatch tier over the same t grid
+static void RunPathBatch(void *context, long long iterations) {
+    const BatchContext *batch = context;
+    for (long long i = 0; i < iterations; i++) {
+        batch->dispatch->pathBatch(batch->path, sampleT, sampleX, sampleY, SAMPLE_COUNT);
+        BenchClobberMemory();
+    }
 }
 
-Vector2 CalculateAngularPath(float t) {
-    if (t < 0.5f) {
-        return (Vector2){t * SCREEN_WIDTH, SCREEN_HEIGHT / 2 - 100};
-    } else {
-        return (Vector2){t * SCREEN_WIDTH, SCREEN_HEIGHT / 2 + 100};
+// Generated kernels of pathSpec.h; `path` is a PATH_SPEC_* id
+static void RunPathSpecBatch(void *context, long long iterations) {
+    const BatchContext *batch = context;
+    for (long long i = 0; i < iterations; i++) {
+        batch->dispatch->pathSpecBatch(batch->path, sampleT, sampleX, sampleY, SAMPLE_COUNT);
+        BenchClobberMemory();
     }
 }
 
-Vector2 CalculateConvexPath(float t) {
-    float y = SCREEN_HEIGHT / 2 - 200 * sinf(t * PI);
-    return (Vector2){t * SCREEN_WIDTH, y};
+// Q16.16 kernels of pathFixed.h over the same t grid
+static void RunPathFixedBatch(void *context, long long iterations) {
+    const BatchContext *batch = context;
+    for (long long i = 0; i < iterations; i++) {
+        batch->dispatch->pathFixedBatch(batch->path, fixedT, fixedX, fixedY, SAMPLE_COUNT);
+        BenchClobberMemory();
+    }
 }
 
-Vector2 CalculateSinusoidalPath(float t) {
-    float y = SCREEN_HEIGHT / 2 + 100 * sinf(t * 4 * PI);
-    return (Vector2){t * SCREEN_WIDTH, y};
+// Runtime-compiled paths, as machine code and through the interpreter
+static const char *jitSources[][3] = {
+    {"angular", "LINEAR(SCREEN_WIDTH, 0)", "ADD(CONST(SCREEN_HEIGHT / 2), STEP(0.5, -100, 100))"},
+    {"sinusoidal", "LINEAR(SCREEN_WIDTH, 0)", "ADD(CONST(SCREEN_HEIGHT / 2), SINE(100, 4 * pi, 0))"},
+    {"damped", "LINEAR(SCREEN_WIDTH, 0)", "ADD(CONST(SCREEN_HEIGHT / 2), MUL(LINEAR(-150, 150), SINE(1, 6 * pi, 0)))"},
+};
+
+// Parse one coordinate of a JIT source; reports where a bad one stops
+static bool ParsePathSource(PathExpr *expr, const char *text) {
+    int offset = 0;
+    if (PathExprParse(expr, text, &offset)) return true;
+    fprintf(stderr, "cannot parse \"%s\" at offset %d\n", text, offset);
+    return false;
+}
+
+static void RunPathJit(void *context, long long iterations) {
+    const PathJit *path = context;
+    for (long long i = 0; i < iterations; i++) {
+        PathJitBatch(path, sampleT, sampleX, sampleY, SAMPLE_COUNT);
+        BenchClobberMemory();
+    }
+}
+
+// Racket test of one dispatch tier over the positions of the last path run
+static void RunRacketBatch(void *context, long long iterations) {
+    const BatchContext *batch = context;
+    Racket racket;
+    InitRacket(&racket);
+    for (long long i = 0; i < iterations; i++) {
+        batch->dispatch->circleHitsRacketBatch(sampleX, sampleY, BALL_RADIUS, &racket, sampleHits, SAMPLE_COUNT);
+        BenchClobberMemory();
+    }
+}
+
+// Incremental steppers over the same sweep
+static void RunPathStepper(void *context, long long iterations) {
+    int path = *(const int *)context;
+    PathStepper stepper;
+    for (long long i = 0; i < iterations; i++) {
+        PathStepperInit(&stepper, path, -0.001f, 0.001f);
+        PathStepperAdvance(&stepper, sampleX, sampleY, SAMPLE_COUNT);
+        BenchClobberMemory();
+    }
 }
 
 // Benchmark Function
-void BenchmarkPathFunctions() {
-    clock_t start, end;
-    const int iterations = 10000000;  // Increase iterations for more accurate timing
-    
-    start = clock();
-    for (int i = 0; i < iterations; i++) {
-        for (float t = 0.0f; t < 1.0f; t += 0.001f) {
-            CalculateStraightPath(t);
+void BenchmarkPathFunctions(BenchConfig *config) {
+    // Every tier up to the bound one, so BALLCORE_TIER also caps the report
+    int maxTier = GetCpuDispatch()->tier;
+
+    BenchReportBegin(config);
+    for (int path = 0; path < PATH_COUNT; path++) {
+        BenchRun(config, pathNames[path], "c", RunPathFunction, (void *)&pathFunctions[path], SAMPLE_COUNT);
+        for (int tier = 0; tier <= maxTier; tier++) {
+            BatchContext batch = {path, GetCpuDispatchForTier(tier)};
+            BenchRun(config, pathNames[path], cpuTierNames[tier], RunPathBatch, &batch, SAMPLE_COUNT);
         }
+        BenchRun(config, pathNames[path], "stepper", RunPathStepper, &path, SAMPLE_COUNT);
     }
-    end = clock();
-    printf("Straight Path Execution Time: %lf seconds\n", ((double)(end - start)) / CLOCKS_PER_SEC);
-
-    start = clock();
-    for (int i = 0; i < iterations; i++) {
-        for (float t = 0.0f; t < 1.0f; t += 0.001f) {
-            CalculateAngularPath(t);
+    static const char *fixedVariants[CPU_TIER_COUNT] = {"fixed-scalar", "fixed-sse2", "fixed-avx2", "fixed-avx512"};
+    for (int path = 0; path < PATH_COUNT; path++) {
+        for (int tier = 0; tier <= maxTier; tier++) {
+            BatchContext batch = {path, GetCpuDispatchForTier(tier)};
+            BenchRun(config, pathNames[path], fixedVariants[tier], RunPathFixedBatch, &batch, SAMPLE_COUNT);
         }
     }
-    end = clock();
-    printf("Angular Path Execution Time: %lf seconds\n", ((double)(end - start)) / CLOCKS_PER_SEC);
-
-    start = clock();
-    for (int i = 0; i < iterations; i++) {
-        for (float t = 0.0f; t < 1.0f; t += 0.001f) {
-            CalculateConvexPath(t);
+    static const char *specVariants[CPU_TIER_COUNT] = {"spec-scalar", "spec-sse2", "spec-avx2", "spec-avx512"};
+    for (int spec = 0; spec < PATH_SPEC_COUNT; spec++) {
+        for (int tier = 0; tier <= maxTier; tier++) {
+            BatchContext batch = {spec, GetCpuDispatchForTier(tier)};
+            BenchRun(config, pathSpecNames[spec], specVariants[tier], RunPathSpecBatch, &batch, SAMPLE_COUNT);
         }
     }
-    end = clock();
-    printf("Convex Path Execution Time: %lf seconds\n", ((double)(end - start)) / CLOCKS_PER_SEC);
+    for (int i = 0; i < (int)(sizeof(jitSources) / sizeof(jitSources[0])); i++) {
+        PathExpr x, y;
+        if (!ParsePathSource(&x, jitSources[i][1]) || !ParsePathSource(&y, jitSources[i][2])) continue;
+        PathJit native, interpreted;
+        PathJitInit(&native, &x, &y, true);
+        PathJitInit(&interpreted, &x, &y, false);
+        if (PathJitIsNative(&native)) BenchRun(config, jitSources[i][0], "jit", RunPathJit, &native, SAMPLE_COUNT);
+        BenchRun(config, jitSources[i][0], "interp", RunPathJit, &interpreted, SAMPLE_COUNT);
+        PathJitFree(&native);
+        PathJitFree(&interpreted);
+    }
+    for (int tier = 0; tier <= maxTier; tier++) {
+        BatchContext batch = {PATH_SINUSOIDAL, GetCpuDispatchForTier(tier)};
+        batch.dispatch->pathBatch(PATH_SINUSOIDAL, sampleT, sampleX, sampleY, SAMPLE_COUNT);
+        BenchRun(config, "racket", cpuTierNames[tier], RunRacketBatch, &batch, SAMPLE_COUNT);
+    }
+    BenchReportEnd(config);
 
-    start = clock();
-    for (int i = 0; i < iterations; i++) {
-        for (float t = 0.0f; t < 1.0f; t += 0.001f) {
-            CalculateSinusoidalPath(t);
+    // Stepper accuracy goes with the timings in the human-readable report
+    if (config->format == BENCH_FORMAT_TEXT) {
+        for (int path = 0; path < PATH_COUNT; path++) {
+            PathStepper stepper;
+            PathStepperInit(&stepper, path, 0.0f, 0.001f);
+            printf("%-12s stepper drift %.6f px (bound %.6f px)\n", pathNames[path],
+                   PathStepperMeasureDrift(path, 0.0f, 0.001f, SAMPLE_COUNT), PathStepperDriftBound(&stepper));
         }
+
+        // Load cost of a path variant: parse both coordinates and compile
+        enum { VARIANTS = 256 };
+        static PathJit variants[VARIANTS];
+        char source[128];
+        int loaded = 0;
+        double start = GetHighPrecisionTime();
+        for (int i = 0; i < VARIANTS; i++) {
+            PathExpr x, y;
+            snprintf(source, sizeof(source), "ADD(CONST(300), MUL(LINEAR(-%d, %d), SINE(1, %d * pi, 0)))",
+                     50 + i % 100, 50 + i % 100, 2 + i % 7);
+            if (!ParsePathSource(&x, "LINEAR(SCREEN_WIDTH, 0)") || !ParsePathSource(&y, source)) break;
+            PathJitInit(&variants[loaded++], &x, &y, true);
+        }
+        double elapsed = GetHighPrecisionTime() - start;
+        if (loaded > 0) {
+            printf("%-12s %d variants loaded in %.3f ms (%.2f us each, %s)\n", "jit", loaded, elapsed * 1e3,
+                   elapsed * 1e6 / loaded, PathJitIsNative(&variants[0]) ? "native" : "interpreted");
+        }
+        for (int i = 0; i < loaded; i++) PathJitFree(&variants[i]);
     }
-    end = clock();
-    printf("Sinusoidal Path Execution Time: %lf seconds\n", ((double)(end - start)) / CLOCKS_PER_SEC);
 }
 
-int main() {
-    BenchmarkPathFunctions();
+int main(int argc, char **argv) {
+    BenchConfig config;
+    BenchConfigDefaults(&config);
+    if (!BenchParseArgs(&config, argc, argv)) {
+        fprintf(stderr, "usage: %s [--csv | --json] [--quick] [--counters] [--trials N] [--label TEXT]\n", argv[0]);
+        return 1;
+    }
+
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        sampleT[i] = i * 0.001f;
+        fixedT[i] = FixedFromFloat(sampleT[i]);
+    }
+
+    BenchmarkPathFunctions(&config);
     return 0;
 }
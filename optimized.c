@@ -1,143 +1,46 @@
-#include "raylib.h"
-#include <math.h>
 #include <stdio.h>
-#include <time.h>  // For benchmarking
-
-#define SCREEN_WIDTH 800
-#define SCREEN_HEIGHT 600
-#define BALL_RADIUS 30
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
-// Optimized path calculations using inline assembly
-Vector2 CalculateStraightPath(float t) {
-    float x;
-    float screenWidth = SCREEN_WIDTH;  // Load SCREEN_WIDTH into a local variable
-    __asm__ volatile (
-        "mulss %[screenWidth], %[t]\n"  // t * SCREEN_WIDTH
-        "movss %[t], %[x]\n"            // Store result in x
-        : [x] "=m" (x)
-        : [t] "x" (t), [screenWidth] "x" (screenWidth)
-        : 
-    );
-    return (Vector2){x, SCREEN_HEIGHT / 2.0f};
-}
-
-Vector2 CalculateAngularPath(float t) {
-    float x, y_offset;
-    float screenWidth = SCREEN_WIDTH;  // Load SCREEN_WIDTH into a local variable
-    float half = 0.5f, plus_offset = 100.0f, minus_offset = -100.0f;
-
-    __asm__ volatile (
-        // Compute x = t * SCREEN_WIDTH
-        "mulss %[screenWidth], %[t]\n"
-        "movss %[t], %[x]\n"
-
-        // Compute y_offset based on t < 0.5
-        "movss %[t], %%xmm0\n"
-        "ucomiss %[half], %%xmm0\n"
-        "jb 1f\n"
-        "movss %[plus_offset], %[y_offset]\n"
-        "jmp 2f\n"
-        "1: movss %[minus_offset], %[y_offset]\n"
-        "2:\n"
-
-        : [x] "=m" (x), [y_offset] "=m" (y_offset)
-        : [t] "x" (t), [screenWidth] "x" (screenWidth),
-          [half] "x" (half), [plus_offset] "x" (plus_offset), [minus_offset] "x" (minus_offset)
-        : "xmm0"
-    );
-
-    return (Vector2){x, (SCREEN_HEIGHT / 2.0f) + y_offset};
-}
-
-Vector2 CalculateConvexPath(float t) {
-    float x, y;
-    float screenWidth = SCREEN_WIDTH;  // Load SCREEN_WIDTH into a local variable
-    float pi = (float)M_PI, neg_amp = -200.0f, offset = SCREEN_HEIGHT / 2.0f;
-
-    // Compute y using C's sinf function
-    y = offset + neg_amp * sinf(t * pi);
-
-    __asm__ volatile (
-        // Compute x = t * SCREEN_WIDTH
-        "mulss %[screenWidth], %[t]\n"
-        "movss %[t], %[x]\n"
-
-        : [x] "=m" (x)
-        : [t] "x" (t), [screenWidth] "x" (screenWidth)
-        : 
-    );
-
-    return (Vector2){x, y};
-}
-
-Vector2 CalculateSinusoidalPath(float t) {
-    float x, y;
-    float screenWidth = SCREEN_WIDTH;  // Load SCREEN_WIDTH into a local variable
-    float four_pi = 4.0f * M_PI, amplitude = 100.0f, offset = SCREEN_HEIGHT / 2.0f;
-
-    // Compute y using C's sinf function
-    y = offset + amplitude * sinf(t * four_pi);
-
-    __asm__ volatile (
-        // Compute x = t * SCREEN_WIDTH
-        "mulss %[screenWidth], %[t]\n"
-        "movss %[t], %[x]\n"
-
-        : [x] "=m" (x)
-        : [t] "x" (t), [screenWidth] "x" (screenWidth)
-        : 
-    );
-
-    return (Vector2){x, y};
-}
-
-// Benchmark Function
-void BenchmarkPathFunctions() {
-    clock_t start, end;
-    const int iterations = 10000000;  // Increase iterations for more accurate timing
-    
-    start = clock();
-    for (int i = 0; i < iterations; i++) {
-        for (float t = 0.0f; t < 1.0f; t += 0.001f) {
-            CalculateStraightPath(t);
+#include "benchHarness.h"
+#include "paths.h"
+
+#define SAMPLE_COUNT 1000  // t = 0, 0.001, ..., 0.999
+
+static float sampleT[SAMPLE_COUNT];
+
+// Path functions of the asm tier; `context` points at the PathFunction to run
+// and every result goes through the sink so the C and asm variants are
+// measured doing the same work
+static void RunPathFunction(void *context, long long iterations) {
+    PathFunction function = *(const PathFunction *)context;
+    for (long long i = 0; i < iterations; i++) {
+        for (int j = 0; j < SAMPLE_COUNT; j++) {
+            Vector2 position = function(sampleT[j]);
+            BenchDoNotOptimize(position.x);
+            BenchDoNotOptimize(position.y);
         }
     }
-    end = clock();
-    printf("Straight Path Execution Time: %lf seconds\n", ((double)(end - start)) / CLOCKS_PER_SEC);
+}
 
-    start = clock();
-    for (int i = 0; i < iterations; i++) {
-        for (float t = 0.0f; t < 1.0f; t += 0.001f) {
-            CalculateAngularPath(t);
-        }
+// Benchmark Function
+void BenchmarkPathFunctions(BenchConfig *config) {
+    BenchReportBegin(config);
+    for (int path = 0; path < PATH_COUNT; path++) {
+        BenchRun(config, pathNames[path], "asm", RunPathFunction, (void *)&pathFunctionsAsm[path], SAMPLE_COUNT);
     }
-    end = clock();
-    printf("Angular Path Execution Time: %lf seconds\n", ((double)(end - start)) / CLOCKS_PER_SEC);
+    BenchReportEnd(config);
+}
 
-    start = clock();
-    for (int i = 0; i < iterations; i++) {
-        for (float t = 0.0f; t < 1.0f; t += 0.001f) {
-            CalculateConvexPath(t);
-        }
+int main(int argc, char **argv) {
+    BenchConfig config;
+    BenchConfigDefaults(&config);
+    if (!BenchParseArgs(&config, argc, argv)) {
+        fprintf(stderr, "usage: %s [--csv | --json] [--quick] [--counters] [--trials N] [--label TEXT]\n", argv[0]);
+        return 1;
     }
-    end = clock();
-    printf("Convex Path Execution Time: %lf seconds\n", ((double)(end - start)) / CLOCKS_PER_SEC);
 
-    start = clock();
-    for (int i = 0; i < iterations; i++) {
-        for (float t = 0.0f; t < 1.0f; t += 0.001f) {
-            CalculateSinusoidalPath(t);
-        }
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        sampleT[i] = i * 0.001f;
     }
-    end = clock();
-    printf("Sinusoidal Path Execution Time: %lf seconds\n", ((double)(end - start)) / CLOCKS_PER_SEC);
-}
 
-int main() {
-    BenchmarkPathFunctions();
+    BenchmarkPathFunctions(&config);
     return 0;
 }
@@ -1,244 +0,0 @@
-// Define macros to prevent Windows from including certain definitions
-#define WIN32_LEAN_AND_MEAN // Prevent unnecessary includes like min/max
-#define NOMINMAX            // Disable the min/max macros to avoid conflicts
-#define NOGDI               // Exclude GDI definitions to avoid conflicting graphical functions
-#define NOUSER              // Exclude user32 (avoiding `DrawTextA` and `LoadImageA` issues)
-#include <raylib.h>         // Include Raylib first
-
-// Explicitly undefine conflicting functions from Windows
-#undef LoadImageA
-#undef DrawTextA
-#undef DrawTextExA
-#undef Rectangle
-#undef CloseWindow
-#undef ShowCursor
-
-// Alias conflicting functions from Raylib to avoid clashes
-#define Rectangle RectangleR
-#define ShowCursor ShowCursorWin
-
-// Provide function aliases if necessary
-void CloseWindowWin(void) {
-    CloseWindow(); // Call the Raylib CloseWindow function
-}
-
-// Now include Windows headers (after Raylib)
-#include <windows.h>        // Include Windows headers
-
-#include <math.h>
-#include <time.h>
-#include <stdio.h>
-#include <stdint.h>
-
-#ifdef _WIN32
-#include <windows.h>
-#else
-#include <sys/time.h>
-#endif
-
-#define SCREEN_WIDTH 800
-#define SCREEN_HEIGHT 600
-#define BALL_RADIUS 30
-#define PATH_STRAIGHT 0
-#define PATH_ANGULAR 1
-#define PATH_CONVEX 2
-#define PATH_SINUSOIDAL 3
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
-// High-precision timer function (renamed to avoid Raylib conflict)
-static double GetHighPrecisionTime() {
-#ifdef _WIN32
-    LARGE_INTEGER frequency;
-    LARGE_INTEGER currentTime;
-    QueryPerformanceFrequency(&frequency);
-    QueryPerformanceCounter(&currentTime);
-    return (double)currentTime.QuadPart / frequency.QuadPart;
-#else
-    struct timeval currentTime;
-    gettimeofday(&currentTime, NULL);
-    return (double)currentTime.tv_sec + (double)currentTime.tv_usec / 1e6;
-#endif
-}
-
-// Ball structure
-typedef struct {
-    Vector2 position;
-    float rotation;
-    Color colors[6];
-    int colorCount;
-} Ball;
-
-// Function to draw a striped ball
-void DrawStripedBall(Ball ball) {
-    for (int i = 0; i < ball.colorCount; i++) {
-        float angleStart = ball.rotation + (i * 360.0f / ball.colorCount);
-        float angleEnd = angleStart + (360.0f / ball.colorCount);
-        DrawCircleSector(ball.position, BALL_RADIUS, angleStart, angleEnd, 10, ball.colors[i]);
-    }
-}
-
-// Path calculation functions
-Vector2 CalculateStraightPath(float t, double *executionTime) {
-    double start = GetHighPrecisionTime();
-    Vector2 result = {t * SCREEN_WIDTH, SCREEN_HEIGHT / 2};
-    double end = GetHighPrecisionTime();
-    *executionTime += (end - start);
-    return result;
-}
-
-Vector2 CalculateAngularPath(float t, double *executionTime) {
-    double start = GetHighPrecisionTime();
-    Vector2 result = {t * SCREEN_WIDTH, SCREEN_HEIGHT * (1.0f - t)};
-    double end = GetHighPrecisionTime();
-    *executionTime += (end - start);
-    return result;
-}
-
-Vector2 CalculateConvexPath(float t, double *executionTime) {
-    double start = GetHighPrecisionTime();
-    float x, y;
-    float screenWidth = SCREEN_WIDTH, pi = (float)M_PI, neg_amp = -200.0f, offset = SCREEN_HEIGHT / 2.0f;
-    y = offset + neg_amp * sinf(t * pi);
-
-    // Optimized inline assembly using SSE
-    __asm__ volatile (
-        "movss %[t], %%xmm0       \n" // Load t into xmm0
-        "mulss %[screenWidth], %%xmm0 \n" // xmm0 = t * screenWidth
-        "movss %%xmm0, %[x]       \n" // Store xmm0 result into x
-        : [x] "=m" (x)
-        : [t] "m" (t), [screenWidth] "m" (screenWidth)
-        : "xmm0"
-    );
-
-    Vector2 result = {x, y};
-    double end = GetHighPrecisionTime();
-    *executionTime += (end - start);
-    return result;
-}
-
-Vector2 CalculateSinusoidalPath(float t, double *executionTime) {
-    double start = GetHighPrecisionTime();
-    float x, y;
-    float screenWidth = SCREEN_WIDTH, four_pi = 4.0f * M_PI, amplitude = 100.0f, offset = SCREEN_HEIGHT / 2.0f;
-    y = offset + amplitude * sinf(t * four_pi);
-
-    // Optimized inline assembly using SSE
-    __asm__ volatile (
-        "movss %[t], %%xmm0       \n" // Load t into xmm0
-        "mulss %[screenWidth], %%xmm0 \n" // xmm0 = t * screenWidth
-        "movss %%xmm0, %[x]       \n" // Store xmm0 result into x
-        : [x] "=m" (x)
-        : [t] "m" (t), [screenWidth] "m" (screenWidth)
-        : "xmm0"
-    );
-
-    Vector2 result = {x, y};
-    double end = GetHighPrecisionTime();
-    *executionTime += (end - start);
-    return result;
-}
-
-
-int main() {
-    // Initialize Raylib window
-    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Colorful Striped Ball Paths with Execution Time");
-    SetTargetFPS(60);
-
-    // Ball properties
-    Ball ball = {
-        .position = {0, SCREEN_HEIGHT / 2},
-        .rotation = 0,
-        .colors = {RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE},
-        .colorCount = 6
-    };
-
-    // Execution time tracking
-    double straightTime = 0.0, angularTime = 0.0, convexTime = 0.0, sinusoidalTime = 0.0;
-
-    // Calculate execution time for each path
-    for (float t = 0.0f; t <= 1.0f; t += 0.01f) {
-        double tempTime = 0.0;
-        CalculateStraightPath(t, &tempTime);
-        straightTime += tempTime;
-
-        tempTime = 0.0;
-        CalculateAngularPath(t, &tempTime);
-        angularTime += tempTime;
-
-        tempTime = 0.0;
-        CalculateConvexPath(t, &tempTime);
-        convexTime += tempTime;
-
-        tempTime = 0.0;
-        CalculateSinusoidalPath(t, &tempTime);
-        sinusoidalTime += tempTime;
-    }
-
-    // Main game loop
-    int selectedPath = PATH_STRAIGHT;
-    float t = 0.0f;
-    bool isMoving = false;
-
-    while (!WindowShouldClose()) {
-        // Handle user input
-        if (IsKeyPressed(KEY_ONE)) selectedPath = PATH_STRAIGHT;
-        if (IsKeyPressed(KEY_TWO)) selectedPath = PATH_ANGULAR;
-        if (IsKeyPressed(KEY_THREE)) selectedPath = PATH_CONVEX;
-        if (IsKeyPressed(KEY_FOUR)) selectedPath = PATH_SINUSOIDAL;
-        if (IsKeyPressed(KEY_SPACE)) isMoving = !isMoving;
-
-        // Update ball position and rotation
-        if (isMoving) {
-            t += 0.01f;
-            if (t > 1.0f) t = 0.0f; // Reset t for looping
-
-            switch (selectedPath) {
-                case PATH_STRAIGHT:
-                    ball.position = CalculateStraightPath(t, &straightTime);
-                    break;
-                case PATH_ANGULAR:
-                    ball.position = CalculateAngularPath(t, &angularTime);
-                    break;
-                case PATH_CONVEX:
-                    ball.position = CalculateConvexPath(t, &convexTime);
-                    break;
-                case PATH_SINUSOIDAL:
-                    ball.position = CalculateSinusoidalPath(t, &sinusoidalTime);
-                    break;
-            }
-            ball.rotation += 5.0f;
-        }
-
-        // Draw everything
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-
-        // Draw the goal/wall
-        DrawRectangle(SCREEN_WIDTH - 10, 0, 10, SCREEN_HEIGHT, BLACK);
-
-        // Draw execution times for all paths
-        DrawText(TextFormat("Execution Time of Straight Path: %.8f seconds", straightTime), 10, 10, 20, DARKGRAY);
-        DrawText(TextFormat("Execution Time of Angular Path: %.8f seconds", angularTime), 10, 40, 20, DARKGRAY);
-        DrawText(TextFormat("Execution Time of Convex Path: %.8f seconds", convexTime), 10, 70, 20, DARKGRAY);
-        DrawText(TextFormat("Execution Time of Sinusoidal Path: %.8f seconds", sinusoidalTime), 10, 100, 20, DARKGRAY);
-
-        // Draw the ball
-        DrawStripedBall(ball);
-
-        // Draw instructions
-        DrawText("Press 1: Straight Path", 10, SCREEN_HEIGHT - 120, 20, DARKGRAY);
-        DrawText("Press 2: Angular Path", 10, SCREEN_HEIGHT - 90, 20, DARKGRAY);
-        DrawText("Press 3: Convex Path", 10, SCREEN_HEIGHT - 60, 20, DARKGRAY);
-        DrawText("Press 4: Sinusoidal Path", 10, SCREEN_HEIGHT - 30, 20, DARKGRAY);
-        DrawText("Press SPACE: Start/Stop", 10, SCREEN_HEIGHT - 150, 20, DARKGRAY);
-
-        EndDrawing();
-    }
-
-    // Close Raylib window
-    CloseWindow();
-    return 0;
-}
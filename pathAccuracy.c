@@ -0,0 +1,283 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpuDispatch.h"
+#include "pathBatch.h"
+#include "pathExpr.h"
+#include "pathFixed.h"
+#include "pathJit.h"
+#include "pathLut.h"
+#include "pathSpec.h"
+#include "pathStepper.h"
+#include "paths.h"
+
+// Accuracy of every path implementation against the double-precision
+// reference (PathEvaluateReference).
+//
+// Each variant evaluates the four paths over a dense grid of t (every
+// multiple of 2^-GRID_BITS in [0, 1], all exact in float). For each path the
+// report gives the largest error in pixels over x and y, the largest error
+// in units in the last place of the reference rounded to float, and the t
+// where the pixel error peaks. A sample off by more than SEMANTIC_PX is a
+// semantic mismatch: the variant draws a different path, not a rounded one.
+// The mismatches are counted and their t range is shown.
+//
+// Every variant has an error budget in pixels and ULPs per path, and the
+// run fails (exit status 1) when one is exceeded. The legacy rows rebuild
+// path definitions the demos used to carry, to show what a mismatch looks
+// like. They are reported but have no budget.
+//
+// The fixed-point rows take t rounded to Q16.16 and are measured against the
+// reference at that t. They must also match fixed-scalar bit for bit; a
+// sample that differs fails the row whatever its error.
+
+#define GRID_BITS 20
+#define GRID_COUNT ((1 << GRID_BITS) + 1)
+#define SEMANTIC_PX 0.5
+#define LUT_RESOLUTION 256
+
+#define KIND_FUNCTION 0   // PathFunction table
+#define KIND_BATCH 1      // CpuDispatch pathBatch of a tier
+#define KIND_SPEC 2       // CpuDispatch pathSpecBatch of a tier
+#define KIND_JIT 3        // pathJit.h, native or interpreted
+#define KIND_LUT 4        // Linear lookup tables
+#define KIND_STEPPER 5    // Incremental stepping
+#define KIND_LEGACY 6     // Old demo definitions
+#define KIND_FIXED 7      // CpuDispatch pathFixedBatch of a tier
+
+typedef struct {
+    double px;            // Largest error in pixels; negative: report only
+    double ulp;           // Largest error in ULPs of the float reference; negative: not checked
+} Budget;
+
+typedef struct {
+    const char *name;
+    int kind;
+    int tier;             // KIND_BATCH / KIND_SPEC / KIND_FIXED: CPU_TIER_*; KIND_JIT: 1 native, 0 interpreted
+    const PathFunction *functions;
+    Budget budgets[PATH_COUNT];
+} Variant;
+
+// Straight and angular are correctly rounded: 0 ULPs, and so within half a
+// float ULP of 800 px. The polynomial sines (FastSin*) and sinf agree with
+// the reference to a few ULPs of y. The stepper adds the rotation drift
+// bounded by PathStepperDriftBound, and the tables their interpolation
+// error; linear tables smooth the angular step over one interval, which
+// only gets reported. Fixed point is exact but for the sine table's
+// interpolation and rounding, scaled by the amplitude; its ULPs are those
+// of a 2^-16 grid, so only pixels are checked.
+#define BUDGET_EXACT {0.0001, 0.0}
+#define BUDGET_SINE {0.001, 16.0}
+#define BUDGET_REPORT {-1.0, -1.0}
+#define BUDGETS_KERNEL {BUDGET_EXACT, BUDGET_EXACT, BUDGET_SINE, BUDGET_SINE}
+#define BUDGETS_STEPPER {BUDGET_EXACT, BUDGET_EXACT, {0.001, 64.0}, {0.001, 64.0}}
+#define BUDGETS_LUT {BUDGET_EXACT, BUDGET_REPORT, {0.01, -1.0}, {0.05, -1.0}}
+#define BUDGETS_FIXED {BUDGET_EXACT, BUDGET_EXACT, {0.004, -1.0}, {0.002, -1.0}}
+#define BUDGETS_NONE {BUDGET_REPORT, BUDGET_REPORT, BUDGET_REPORT, BUDGET_REPORT}
+
+// Old angular path of the movingBall demos and OptimizedInteractionBall: a
+// diagonal from the bottom left corner instead of a +-100 px step
+static Vector2 LegacyDiagonalAngularPath(float t) {
+    return (Vector2){t * SCREEN_WIDTH, SCREEN_HEIGHT * (1.0f - t)};
+}
+
+static const PathFunction legacyDiagonal[PATH_COUNT] = {NULL, LegacyDiagonalAngularPath, NULL, NULL};
+
+// x and y programs of the four paths for the expression compiler
+static const char *pathSources[PATH_COUNT][2] = {
+    {"LINEAR(SCREEN_WIDTH, 0)", "CONST(SCREEN_HEIGHT / 2)"},
+    {"LINEAR(SCREEN_WIDTH, 0)", "ADD(CONST(SCREEN_HEIGHT / 2), STEP(0.5, -100, 100))"},
+    {"LINEAR(SCREEN_WIDTH, 0)", "ADD(CONST(SCREEN_HEIGHT / 2), SINE(-200, pi, 0))"},
+    {"LINEAR(SCREEN_WIDTH, 0)", "ADD(CONST(SCREEN_HEIGHT / 2), SINE(100, 4 * pi, 0))"},
+};
+
+static float gridT[GRID_COUNT], gridX[GRID_COUNT], gridY[GRID_COUNT];
+static float evalT[GRID_COUNT];  // t the variant actually saw
+static Fixed fixedT[GRID_COUNT], fixedX[GRID_COUNT], fixedY[GRID_COUNT];
+static Fixed scalarX[GRID_COUNT], scalarY[GRID_COUNT];
+static int bitDifferences;       // KIND_FIXED samples that differ from fixed-scalar
+
+// Distance in ULPs between two floats, through their ordered integer images
+static double UlpDistance(float a, float b) {
+    int ia, ib;
+    memcpy(&ia, &a, sizeof(ia));
+    memcpy(&ib, &b, sizeof(ib));
+    long long la = ia < 0 ? -(long long)(ia & 0x7fffffff) : ia;
+    long long lb = ib < 0 ? -(long long)(ib & 0x7fffffff) : ib;
+    return (double)llabs(la - lb);
+}
+
+// Fill gridX / gridY with the variant's positions; false when it does not
+// exist on this machine
+static bool Evaluate(const Variant *variant, int path) {
+    memcpy(evalT, gridT, sizeof(evalT));
+    bitDifferences = 0;
+    switch (variant->kind) {
+        case KIND_FUNCTION:
+        case KIND_LEGACY:
+            if (variant->functions[path] == NULL) return false;
+            for (int i = 0; i < GRID_COUNT; i++) {
+                Vector2 position = variant->functions[path](gridT[i]);
+                gridX[i] = position.x;
+                gridY[i] = position.y;
+            }
+            return true;
+        case KIND_BATCH:
+            GetCpuDispatchForTier(variant->tier)->pathBatch(path, gridT, gridX, gridY, GRID_COUNT);
+            return true;
+        case KIND_SPEC:
+            // The first PATH_SPEC_* ids are the four paths in PATH_* order
+            GetCpuDispatchForTier(variant->tier)->pathSpecBatch(path, gridT, gridX, gridY, GRID_COUNT);
+            return true;
+        case KIND_JIT: {
+            PathExpr x, y;
+            PathJit jit;
+            for (int i = 0; i < 2; i++) {
+                int offset = 0;
+                if (PathExprParse(i == 0 ? &x : &y, pathSources[path][i], &offset)) continue;
+                fprintf(stderr, "%s: cannot parse \"%s\" at offset %d\n", pathNames[path], pathSources[path][i], offset);
+                return false;
+            }
+            if (!PathJitInit(&jit, &x, &y, variant->tier == 1)) return false;
+            bool present = variant->tier == 0 || PathJitIsNative(&jit);
+            if (present) PathJitBatch(&jit, gridT, gridX, gridY, GRID_COUNT);
+            PathJitFree(&jit);
+            return present;
+        }
+        case KIND_LUT: {
+            PathLut lut;
+            if (!PathLutInit(&lut, path, LUT_RESOLUTION)) return false;
+            PathLutSampleBatch(&lut, PATH_LUT_LINEAR, gridT, gridX, gridY, GRID_COUNT);
+            PathLutFree(&lut);
+            return true;
+        }
+        case KIND_STEPPER: {
+            // Positions after each step, so start one step before t = 0
+            PathStepper stepper;
+            float dt = 1.0f / (1 << GRID_BITS);
+            PathStepperInit(&stepper, path, -dt, dt);
+            PathStepperAdvance(&stepper, gridX, gridY, GRID_COUNT);
+            return true;
+        }
+        case KIND_FIXED:
+            GetCpuDispatchForTier(variant->tier)->pathFixedBatch(path, fixedT, fixedX, fixedY, GRID_COUNT);
+            PathFixedBatchScalar(path, fixedT, scalarX, scalarY, GRID_COUNT);
+            for (int i = 0; i < GRID_COUNT; i++) {
+                evalT[i] = FixedToFloat(fixedT[i]);
+                gridX[i] = FixedToFloat(fixedX[i]);
+                gridY[i] = FixedToFloat(fixedY[i]);
+                if (fixedX[i] != scalarX[i] || fixedY[i] != scalarY[i]) bitDifferences++;
+            }
+            return true;
+    }
+    return false;
+}
+
+typedef struct {
+    double px;
+    double ulp;
+    float worstT;
+    int mismatches;
+    float firstMismatch;
+    float lastMismatch;
+} PathError;
+
+static void Measure(int path, PathError *error) {
+    memset(error, 0, sizeof(*error));
+    for (int i = 0; i < GRID_COUNT; i++) {
+        double refX, refY;
+        PathEvaluateReference(path, evalT[i], &refX, &refY);
+        double px = fmax(fabs(gridX[i] - refX), fabs(gridY[i] - refY));
+        double ulp = fmax(UlpDistance(gridX[i], (float)refX), UlpDistance(gridY[i], (float)refY));
+        if (px > error->px) {
+            error->px = px;
+            error->worstT = evalT[i];
+        }
+        if (ulp > error->ulp) error->ulp = ulp;
+        if (px > SEMANTIC_PX) {
+            if (error->mismatches == 0) error->firstMismatch = evalT[i];
+            error->lastMismatch = evalT[i];
+            error->mismatches++;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    bool csv = argc > 1 && strcmp(argv[1], "--csv") == 0;
+    if (argc > 2 || (argc == 2 && !csv)) {
+        fprintf(stderr, "usage: %s [--csv]\n", argv[0]);
+        return 1;
+    }
+    for (int i = 0; i < GRID_COUNT; i++) {
+        gridT[i] = (float)i / (1 << GRID_BITS);
+        fixedT[i] = FixedFromFloat(gridT[i]);
+    }
+
+    static const char *batchNames[CPU_TIER_COUNT] = {"batch-scalar", "batch-sse2", "batch-avx2", "batch-avx512"};
+    static const char *fixedNames[CPU_TIER_COUNT] = {"fixed-scalar", "fixed-sse2", "fixed-avx2", "fixed-avx512"};
+    static const char *specNames[CPU_TIER_COUNT] = {"spec-scalar", "spec-sse2", "spec-avx2", "spec-avx512"};
+    Variant variants[32];
+    int variantCount = 0;
+    variants[variantCount++] = (Variant){"c", KIND_FUNCTION, 0, pathFunctions, BUDGETS_KERNEL};
+    variants[variantCount++] = (Variant){"asm", KIND_FUNCTION, 0, pathFunctionsAsm, BUDGETS_KERNEL};
+    for (int tier = 0; tier <= GetCpuDispatch()->tier; tier++) {
+        variants[variantCount++] = (Variant){batchNames[tier], KIND_BATCH, tier, NULL, BUDGETS_KERNEL};
+    }
+    for (int tier = 0; tier <= GetCpuDispatch()->tier; tier++) {
+        variants[variantCount++] = (Variant){specNames[tier], KIND_SPEC, tier, NULL, BUDGETS_KERNEL};
+    }
+    for (int tier = 0; tier <= GetCpuDispatch()->tier; tier++) {
+        variants[variantCount++] = (Variant){fixedNames[tier], KIND_FIXED, tier, NULL, BUDGETS_FIXED};
+    }
+    variants[variantCount++] = (Variant){"jit", KIND_JIT, 1, NULL, BUDGETS_KERNEL};
+    variants[variantCount++] = (Variant){"interp", KIND_JIT, 0, NULL, BUDGETS_KERNEL};
+    variants[variantCount++] = (Variant){"lut-linear", KIND_LUT, 0, NULL, BUDGETS_LUT};
+    variants[variantCount++] = (Variant){"stepper", KIND_STEPPER, 0, NULL, BUDGETS_STEPPER};
+    variants[variantCount++] = (Variant){"legacy-diagonal", KIND_LEGACY, 0, legacyDiagonal, BUDGETS_NONE};
+
+    if (csv) {
+        printf("variant,path,max_px,max_ulp,worst_t,mismatches,first_mismatch_t,last_mismatch_t,bit_differences,"
+               "budget_px,budget_ulp,status\n");
+    } else {
+        printf("%d samples per path, mismatch above %.1f px\n", GRID_COUNT, SEMANTIC_PX);
+        printf("%-15s %-11s %12s %12s %10s  %s\n", "variant", "path", "max px", "max ulp", "worst t", "status");
+    }
+
+    int failures = 0;
+    for (int v = 0; v < variantCount; v++) {
+        const Variant *variant = &variants[v];
+        for (int path = 0; path < PATH_COUNT; path++) {
+            if (!Evaluate(variant, path)) continue;
+            PathError error;
+            Measure(path, &error);
+
+            const Budget *budget = &variant->budgets[path];
+            const char *status = "ok";
+            if (budget->px < 0.0) {
+                status = "report";
+            } else if (error.px > budget->px || (budget->ulp >= 0.0 && error.ulp > budget->ulp) ||
+                       bitDifferences > 0) {
+                status = "FAIL";
+                failures++;
+            }
+
+            if (csv) {
+                printf("%s,%s,%.6g,%.0f,%.7f,%d,%.7f,%.7f,%d,%g,%g,%s\n", variant->name, pathNames[path], error.px,
+                       error.ulp, error.worstT, error.mismatches, error.firstMismatch, error.lastMismatch,
+                       bitDifferences, budget->px, budget->ulp, status);
+                continue;
+            }
+            printf("%-15s %-11s %12.6g %12.0f %10.7f  %s", variant->name, pathNames[path], error.px, error.ulp,
+                   error.worstT, status);
+            if (error.mismatches > 0) {
+                printf("  MISMATCH on %d samples, t %.7f to %.7f", error.mismatches, error.firstMismatch,
+                       error.lastMismatch);
+            }
+            if (bitDifferences > 0) printf("  DIFFERS from fixed-scalar on %d samples", bitDifferences);
+            printf("\n");
+        }
+    }
+    if (!csv) printf("%d variant%s over budget\n", failures, failures == 1 ? "" : "s");
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,343 @@
+#define _GNU_SOURCE  // sched_getaffinity, pthread_setaffinity_np
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpuDispatch.h"
+#include "paths.h"
+#include "timing.h"
+
+// Multi-core scaling of the path kernels.
+//
+// Every path runs over one large t array (far bigger than the caches by
+// default) on 1, 2, 4, ... and N threads, each thread pinned to its own CPU
+// and sweeping a contiguous slice. The variants are the scalar path
+// functions ("c") and the batch kernels of every dispatch tier up to the
+// bound one. A "stream" kernel that only copies t into x and y moves the
+// same bytes with no arithmetic; its rate at each thread count is the
+// memory bandwidth the kernels can hope for.
+//
+// Each worker writes its own full-count slice of t, x and y first, from its
+// pinned CPU, so on a NUMA machine those pages sit on the node that sweeps
+// them.
+//
+// For each run the tool reports samples/s, the bytes the kernel reads and
+// writes per second (12 per sample: t in, x and y out; write-allocate
+// traffic is not counted), speedup and parallel efficiency against one
+// thread, and the fraction of the stream bandwidth at the same thread count.
+// A kernel at SCALING_MEMORY_BOUND of it or more is memory-bound there:
+// more threads cannot make it faster, only more bandwidth can.
+
+#define SCALING_MEMORY_BOUND 0.85
+#define SCALING_BYTES_PER_SAMPLE 12.0
+#define SCALING_MAX_THREADS 1024
+
+#define VARIANT_STREAM -2
+#define VARIANT_C -1     // Otherwise a CPU_TIER_*
+
+typedef struct {
+    long long samples;
+    int threads;            // Most threads (0 = every CPU this process may use)
+    int trials;             // Best of
+    bool pin;
+    bool csv;
+} ScalingOptions;
+
+typedef struct {
+    float *t;
+    float *x;
+    float *y;
+    long long samples;
+    int workers;
+    int cpus[SCALING_MAX_THREADS];   // CPU of each worker
+    int cpuCount;
+    pthread_mutex_t startup;  // Held by the main thread until the worker count is final
+    pthread_barrier_t start;
+    pthread_barrier_t done;
+
+    // The round in progress, set by the main thread between barriers
+    int path;
+    int variant;
+    int active;             // Workers with a slice; the others sit the round out
+    bool quit;
+} ScalingPool;
+
+typedef struct {
+    ScalingPool *pool;
+    int index;
+} ScalingWorker;
+
+static void Usage(const char *program) {
+    fprintf(stderr,
+            "usage: %s [--samples N] [--threads N] [--trials N] [--no-pin] [--quick] [--csv]\n", program);
+}
+
+static bool ParseOptions(ScalingOptions *options, int argc, char **argv) {
+    options->samples = 1 << 23;
+    options->threads = 0;
+    options->trials = 3;
+    options->pin = true;
+    options->csv = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            options->samples = atoll(argv[++i]);
+            if (options->samples < 1 || options->samples > 0x7fffffff) return false;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options->threads = atoi(argv[++i]);
+            if (options->threads < 1 || options->threads > SCALING_MAX_THREADS) return false;
+        } else if (strcmp(argv[i], "--trials") == 0 && i + 1 < argc) {
+            options->trials = atoi(argv[++i]);
+            if (options->trials < 1) return false;
+        } else if (strcmp(argv[i], "--no-pin") == 0) {
+            options->pin = false;
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            options->samples = 1 << 21;
+            options->trials = 1;
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            options->csv = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The CPUs this process may run on, in order
+static int AllowedCpus(int *cpus, int capacity) {
+    int count = 0;
+#ifdef __linux__
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE && count < capacity; cpu++) {
+            if (CPU_ISSET(cpu, &set)) cpus[count++] = cpu;
+        }
+    }
+#endif
+    if (count == 0) cpus[count++] = -1;  // Unknown: one, unpinned
+    return count;
+}
+
+static void PinThread(pthread_t thread, int cpu) {
+#ifdef __linux__
+    if (cpu < 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(thread, sizeof(set), &set);
+#else
+    (void)thread;
+    (void)cpu;
+#endif
+}
+
+// Copy t into x and y, in blocks of a fixed trip count so the compiler
+// vectorizes them at -O2
+static void Stream(const float *restrict t, float *restrict x, float *restrict y, int count) {
+    int i = 0;
+    for (; i + 64 <= count; i += 64) {
+        for (int j = 0; j < 64; j++) {
+            x[i + j] = t[i + j];
+            y[i + j] = t[i + j];
+        }
+    }
+    for (; i < count; i++) {
+        x[i] = t[i];
+        y[i] = t[i];
+    }
+}
+
+static void RunSlice(const ScalingPool *pool, long long begin, long long end) {
+    int count = (int)(end - begin);
+    const float *t = pool->t + begin;
+    float *x = pool->x + begin, *y = pool->y + begin;
+
+    if (pool->variant == VARIANT_STREAM) {
+        Stream(t, x, y, count);
+    } else if (pool->variant == VARIANT_C) {
+        PathFunction function = pathFunctions[pool->path];
+        for (int i = 0; i < count; i++) {
+            Vector2 position = function(t[i]);
+            x[i] = position.x;
+            y[i] = position.y;
+        }
+    } else {
+        GetCpuDispatchForTier(pool->variant)->pathBatch(pool->path, t, x, y, count);
+    }
+}
+
+// Write the worker's slice of t, x and y for the first time
+static void FirstTouch(const ScalingPool *pool, int index) {
+    long long begin = pool->samples * index / pool->workers;
+    long long end = pool->samples * (index + 1) / pool->workers;
+    for (long long i = begin; i < end; i++) {
+        pool->t[i] = (float)((double)i / (double)pool->samples);
+        pool->x[i] = 0.0f;
+        pool->y[i] = 0.0f;
+    }
+}
+
+static void *WorkerMain(void *argument) {
+    ScalingWorker *worker = argument;
+    ScalingPool *pool = worker->pool;
+
+    // Wait until every thread is created and pinned and the barriers exist
+    pthread_mutex_lock(&pool->startup);
+    pthread_mutex_unlock(&pool->startup);
+    FirstTouch(pool, worker->index);
+
+    for (;;) {
+        pthread_barrier_wait(&pool->start);
+        if (pool->quit) break;
+        if (worker->index < pool->active) {
+            long long begin = pool->samples * worker->index / pool->active;
+            long long end = pool->samples * (worker->index + 1) / pool->active;
+            RunSlice(pool, begin, end);
+        }
+        pthread_barrier_wait(&pool->done);
+    }
+    return NULL;
+}
+
+// One round on `active` workers; returns its wall time in seconds
+static double RunRound(ScalingPool *pool, int path, int variant, int active) {
+    pool->path = path;
+    pool->variant = variant;
+    pool->active = active;
+    double start = GetHighPrecisionTime();
+    pthread_barrier_wait(&pool->start);
+    pthread_barrier_wait(&pool->done);
+    return GetHighPrecisionTime() - start;
+}
+
+static double BestRound(ScalingPool *pool, int path, int variant, int active, int trials) {
+    RunRound(pool, path, variant, active);  // Warm-up
+    double best = RunRound(pool, path, variant, active);
+    for (int trial = 1; trial < trials; trial++) {
+        double seconds = RunRound(pool, path, variant, active);
+        if (seconds < best) best = seconds;
+    }
+    return best;
+}
+
+static const char *VariantName(int variant) {
+    return variant == VARIANT_STREAM ? "stream" : variant == VARIANT_C ? "c" : cpuTierNames[variant];
+}
+
+int main(int argc, char **argv) {
+    ScalingOptions options;
+    if (!ParseOptions(&options, argc, argv)) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    static ScalingPool pool;
+    pool.cpuCount = AllowedCpus(pool.cpus, SCALING_MAX_THREADS);
+    pool.workers = options.threads > 0 ? options.threads : pool.cpuCount;
+    pool.samples = options.samples;
+    pool.t = malloc(sizeof(float) * (size_t)options.samples);
+    pool.x = malloc(sizeof(float) * (size_t)options.samples);
+    pool.y = malloc(sizeof(float) * (size_t)options.samples);
+    if (pool.t == NULL || pool.x == NULL || pool.y == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    // The workers block on `startup`, so a failed create can still shrink the
+    // pool before the barriers are sized
+    pthread_mutex_init(&pool.startup, NULL);
+    pthread_mutex_lock(&pool.startup);
+    pthread_t threads[SCALING_MAX_THREADS];
+    ScalingWorker workers[SCALING_MAX_THREADS];
+    int created = 0;
+    for (; created < pool.workers; created++) {
+        workers[created] = (ScalingWorker){&pool, created};
+        if (pthread_create(&threads[created], NULL, WorkerMain, &workers[created]) != 0) break;
+        if (options.pin) PinThread(threads[created], pool.cpus[created % pool.cpuCount]);
+    }
+    if (created == 0) {
+        fprintf(stderr, "cannot start a worker thread\n");
+        return 1;
+    }
+    if (created < pool.workers) {
+        fprintf(stderr, "only %d of %d worker threads started\n", created, pool.workers);
+        pool.workers = created;
+    }
+    pthread_barrier_init(&pool.start, NULL, (unsigned)pool.workers + 1);
+    pthread_barrier_init(&pool.done, NULL, (unsigned)pool.workers + 1);
+    pthread_mutex_unlock(&pool.startup);
+
+    // 1, 2, 4, ... and the full count
+    int counts[32], countCount = 0;
+    for (int n = 1; n < pool.workers; n *= 2) counts[countCount++] = n;
+    counts[countCount++] = pool.workers;
+
+    // Stream bandwidth at each thread count, the ceiling for the kernels
+    double streamRate[32];
+    for (int c = 0; c < countCount; c++) {
+        streamRate[c] = options.samples / BestRound(&pool, 0, VARIANT_STREAM, counts[c], options.trials);
+    }
+
+    int maxTier = GetCpuDispatch()->tier;
+    if (options.csv) {
+        printf("path,variant,threads,samples,msamples_per_s,gb_per_s,speedup,efficiency,stream_fraction\n");
+        for (int c = 0; c < countCount; c++) {
+            printf("stream,stream,%d,%lld,%.2f,%.3f,%.3f,%.3f,1.000\n", counts[c], options.samples,
+                   streamRate[c] / 1e6, streamRate[c] * SCALING_BYTES_PER_SAMPLE / 1e9,
+                   streamRate[c] / streamRate[0], streamRate[c] / streamRate[0] / counts[c]);
+        }
+    } else {
+        printf("%lld samples (%.0f MB), %d threads on %d CPUs, %s\n", options.samples,
+               options.samples * SCALING_BYTES_PER_SAMPLE / 1e6, pool.workers, pool.cpuCount,
+               options.pin ? "pinned" : "not pinned");
+        printf("%-12s %-8s %7s %12s %8s %8s %10s %8s\n", "path", "variant", "threads", "Msamples/s", "GB/s",
+               "speedup", "efficiency", "stream");
+        for (int c = 0; c < countCount; c++) {
+            printf("%-12s %-8s %7d %12.1f %8.2f %8.2f %9.0f%% %7.0f%%\n", "stream", "stream", counts[c],
+                   streamRate[c] / 1e6, streamRate[c] * SCALING_BYTES_PER_SAMPLE / 1e9,
+                   streamRate[c] / streamRate[0], 100.0 * streamRate[c] / streamRate[0] / counts[c], 100.0);
+        }
+    }
+
+    for (int path = 0; path < PATH_COUNT; path++) {
+        for (int variant = VARIANT_C; variant <= maxTier; variant++) {
+            double rate[32];
+            int memoryBoundFrom = 0;
+            for (int c = 0; c < countCount; c++) {
+                rate[c] = options.samples / BestRound(&pool, path, variant, counts[c], options.trials);
+                double speedup = rate[c] / rate[0], fraction = rate[c] / streamRate[c];
+                if (memoryBoundFrom == 0 && fraction >= SCALING_MEMORY_BOUND) memoryBoundFrom = counts[c];
+
+                if (options.csv) {
+                    printf("%s,%s,%d,%lld,%.2f,%.3f,%.3f,%.3f,%.3f\n", pathNames[path], VariantName(variant),
+                           counts[c], options.samples, rate[c] / 1e6, rate[c] * SCALING_BYTES_PER_SAMPLE / 1e9,
+                           speedup, speedup / counts[c], fraction);
+                } else {
+                    printf("%-12s %-8s %7d %12.1f %8.2f %8.2f %9.0f%% %7.0f%%\n", pathNames[path],
+                           VariantName(variant), counts[c], rate[c] / 1e6, rate[c] * SCALING_BYTES_PER_SAMPLE / 1e9,
+                           speedup, 100.0 * speedup / counts[c], 100.0 * fraction);
+                }
+            }
+            if (options.csv) continue;
+            if (memoryBoundFrom > 0) {
+                printf("%-12s %-8s memory-bound from %d thread%s\n", pathNames[path], VariantName(variant),
+                       memoryBoundFrom, memoryBoundFrom > 1 ? "s" : "");
+            } else {
+                printf("%-12s %-8s compute-bound up to %d thread%s (%.0f%% of stream bandwidth)\n",
+                       pathNames[path], VariantName(variant), pool.workers, pool.workers > 1 ? "s" : "",
+                       100.0 * rate[countCount - 1] / streamRate[countCount - 1]);
+            }
+        }
+    }
+
+    pool.quit = true;
+    pthread_barrier_wait(&pool.start);
+    for (int i = 0; i < pool.workers; i++) pthread_join(threads[i], NULL);
+    pthread_barrier_destroy(&pool.start);
+    pthread_barrier_destroy(&pool.done);
+    pthread_mutex_destroy(&pool.startup);
+    free(pool.t);
+    free(pool.x);
+    free(pool.y);
+    return 0;
+}
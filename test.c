@@ -1,173 +1,93 @@
 #include "raylib.h"
 #include <stdio.h>
-#include <math.h>
-#include <time.h>
-#include <string.h>  // Include for strlen
+#include "ballDraw.h"
+#include "benchHarness.h"
+#include "cpuDispatch.h"
+#include "frameStats.h"
+#include "pathArcLength.h"
+#include "pathLut.h"
+#include "pathStepper.h"
+#include "paths.h"
 
-#define SCREEN_WIDTH 800
-#define SCREEN_HEIGHT 600
-#define BALL_RADIUS 30
-#define PATH_STRAIGHT 0
-#define PATH_ANGULAR 1
-#define PATH_CONVEX 2
-#define PATH_SINUSOIDAL 3
+#define LUT_RESOLUTION 256  // Table intervals per path (about 2 KB each)
+#define ARC_RESOLUTION 256  // Arc-length table intervals per path (about 1 KB each)
 
-#define PI 3.14159265358979323846f  // Define PI if it's not already available
-
-typedef struct {
-    Vector2 position;
-    float rotation;
-    Color colors[6];
-    int colorCount;
-} Ball;
-
-void DrawStripedBall(Ball ball) {
-    for (int i = 0; i < ball.colorCount; i++) {
-        float angleStart = ball.rotation + (i * 360.0f / ball.colorCount);
-        float angleEnd = angleStart + (360.0f / ball.colorCount);
-        DrawCircleSector(ball.position, BALL_RADIUS, angleStart, angleEnd, 0, ball.colors[i]);
+// Path functions of the asm tier; `context` points at the PathFunction to run
+// and every result goes through the benchmark sink
+static void RunPathFunction(void *context, long long iterations) {
+    PathFunction function = *(const PathFunction *)context;
+    for (long long i = 0; i < iterations; i++) {
+        for (int j = 0; j < 1000; j++) {
+            Vector2 position = function(j * 0.001f);
+            BenchDoNotOptimize(position.x);
+            BenchDoNotOptimize(position.y);
+        }
     }
 }
 
-Vector2 CalculateStraightPath(float t) {
-    Vector2 result;
-    float width = SCREEN_WIDTH;
-    float mid = SCREEN_HEIGHT / 2.0f;
-    __asm__ volatile (
-        "movss %[t], %%xmm0\n"       // Load t into xmm0
-        "mulss %[width], %%xmm0\n"   // Multiply t by width
-        "movss %%xmm0, %[x]\n"       // Store result into result.x
-        "movss %[mid], %%xmm1\n"     // Load mid into xmm1
-        "movss %%xmm1, %[y]\n"       // Store result into result.y
-        : [x] "=m" (result.x), [y] "=m" (result.y)
-        : [t] "m" (t), [width] "m" (width), [mid] "m" (mid)
-        : "xmm0", "xmm1", "memory"
-    );
-    return result;
-}
-
-Vector2 CalculateAngularPath(float t) {
-    Vector2 result;
-    float width = SCREEN_WIDTH;
-    float mid = SCREEN_HEIGHT / 2.0f;
-    float offset = (t < 0.5f) ? -100.0f : 100.0f;
-    __asm__ volatile (
-        "movss %[t], %%xmm0\n"
-        "mulss %[width], %%xmm0\n"
-        "movss %[mid], %%xmm1\n"
-        "addss %[offset], %%xmm1\n"
-        "movss %%xmm0, %[x]\n"
-        "movss %%xmm1, %[y]\n"
-        : [x] "=m" (result.x), [y] "=m" (result.y)
-        : [t] "m" (t), [width] "m" (width), [mid] "m" (mid), [offset] "m" (offset)
-        : "xmm0", "xmm1", "memory"
-    );
-    return result;
-}
+void BenchmarkPathFunctions(char *output, size_t size) {
+    static const char *names[PATH_COUNT] = {"Straight", "Angular", "Convex", "Sinusoidal"};
+    BenchConfig config;
 
-Vector2 CalculateConvexPath(float t) {
-    Vector2 result;
-    float y;
-    float pi = PI;
-    float amp = -200.0f;
-    float mid = SCREEN_HEIGHT / 2.0f;
-    __asm__ volatile (
-        "movss %[t], %%xmm0\n"          // Load t into xmm0
-        "mulss %[pi], %%xmm0\n"         // Multiply t by PI
-        "call sinf\n"                   // Call sinf function (result in xmm0)
-        "mulss %[amp], %%xmm0\n"        // Multiply result by amplitude
-        "addss %[mid], %%xmm0\n"        // Add offset to the result
-        "movss %%xmm0, %[y]\n"          // Store the result in y
-        : [y] "=m" (y)
-        : [t] "m" (t), [pi] "m" (pi), [amp] "m" (amp), [mid] "m" (mid)
-        : "xmm0", "memory"
-    );
-    result.x = t * SCREEN_WIDTH;
-    result.y = y;
-    return result;
-}
+    // Short trials so the window does not freeze; results go on screen only
+    BenchConfigDefaults(&config);
+    BenchParseArgs(&config, 2, (char *[]){"", "--quick"});
+    config.out = NULL;
 
-Vector2 CalculateSinusoidalPath(float t) {
-    Vector2 result;
-    float y;
-    float four_pi = 4.0f * PI;
-    float amplitude = 100.0f;
-    float offset = SCREEN_HEIGHT / 2.0f;
-    __asm__ volatile (
-        "movss %[t], %%xmm0\n"          // Load t into xmm0
-        "mulss %[four_pi], %%xmm0\n"    // Multiply t by 4 * PI
-        "call sinf\n"                   // Call sinf function (result in xmm0)
-        "mulss %[amplitude], %%xmm0\n"  // Multiply result by amplitude
-        "addss %[offset], %%xmm0\n"     // Add offset to the result
-        "movss %%xmm0, %[y]\n"          // Store the result in y
-        : [y] "=m" (y)
-        : [t] "m" (t), [four_pi] "m" (four_pi), [amplitude] "m" (amplitude), [offset] "m" (offset)
-        : "xmm0", "memory"
-    );
-    result.x = t * SCREEN_WIDTH;
-    result.y = y;
-    return result;
-}
-
-void BenchmarkPathFunctions(char *output) {
-    clock_t start, end;
-    
-    // Benchmark for Straight Path
-    start = clock();
-    for (int i = 0; i < 2; i++) {
-        for (float t = 0.0f; t < 1.0f; t += 0.001f) {
-            CalculateStraightPath(t);
-        }
+    output[0] = '\0';
+    size_t used = 0;
+    for (int path = 0; path < PATH_COUNT && used < size; path++) {
+        BenchResult result = BenchRun(&config, names[path], "asm", RunPathFunction, (void *)&pathFunctionsAsm[path], 1000);
+        // Truncates rather than overflows when the timings are long
+        int written = snprintf(output + used, size - used, "%s%s Path: %.3f ns/sample (p99 %.3f)",
+                               path > 0 ? "\n" : "", names[path], result.medianNs, result.p99Ns);
+        if (written < 0) break;
+        used += (size_t)written;
     }
-    end = clock();
-    sprintf(output, "Straight Path: %lf seconds", ((double)(end - start)) / CLOCKS_PER_SEC);
-    
-    // Benchmark for Angular Path
-    start = clock();
-    for (int i = 0; i < 2; i++) {
-        for (float t = 0.0f; t < 1.0f; t += 0.001f) {
-            CalculateAngularPath(t);
-        }
-    }
-    end = clock();
-    sprintf(output + strlen(output), "\nAngular Path: %lf seconds", ((double)(end - start)) / CLOCKS_PER_SEC);
-    
-    // Benchmark for Convex Path
-    start = clock();
-    for (int i = 0; i < 2; i++) {
-        for (float t = 0.0f; t < 1.0f; t += 0.001f) {
-            CalculateConvexPath(t);
-        }
-    }
-    end = clock();
-    sprintf(output + strlen(output), "\nConvex Path: %lf seconds", ((double)(end - start)) / CLOCKS_PER_SEC);
-    
-    // Benchmark for Sinusoidal Path
-    start = clock();
-    for (int i = 0; i < 2; i++) {
-        for (float t = 0.0f; t < 1.0f; t += 0.001f) {
-            CalculateSinusoidalPath(t);
-        }
-    }
-    end = clock();
-    sprintf(output + strlen(output), "\nSinusoidal Path: %lf seconds", ((double)(end - start)) / CLOCKS_PER_SEC);
 }
 
 int main() {
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Benchmark and Graphics");
 
-    Ball ball = {
-        .position = {0, SCREEN_HEIGHT / 2},
-        .rotation = 0,
-        .colors = {RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE},
-        .colorCount = 6
-    };
+    Ball ball;
+    InitBall(&ball);
     
     int selectedPath = PATH_STRAIGHT;
     float t = 0.0f;
     bool isMoving = true;  // Set this to true to move the ball
     char benchmarkOutput[256] = "";  // To store benchmark results
+    bool useLut = false;  // Sample the precomputed tables instead of the path functions
+    bool useStepper = false;  // Advance the path incrementally instead of evaluating it
+    PathStepper stepper;
+    bool constantSpeed = false;  // Advance by distance along the path instead of by t
+    float distance = 0.0f;
+
+    // Build the lookup tables once at startup; zeroed so every Free below is
+    // safe whichever Init failed
+    PathLut luts[PATH_COUNT] = {0};
+    PathArcTable arcs[PATH_COUNT] = {0};
+    bool tablesReady = true;
+    for (int path = 0; path < PATH_COUNT; path++) {
+        tablesReady &= PathLutInit(&luts[path], path, LUT_RESOLUTION);
+        tablesReady &= PathArcTableInit(&arcs[path], path, ARC_RESOLUTION);
+    }
+    if (!tablesReady) {
+        fprintf(stderr, "cannot start: out of memory\n");
+        for (int path = 0; path < PATH_COUNT; path++) {
+            PathLutFree(&luts[path]);
+            PathArcTableFree(&arcs[path]);
+        }
+        CloseWindow();
+        return 1;
+    }
     
+    // Rolling frame times and their split into phases, drawn with key F;
+    // BALLCORE_FRAME_CSV=file.csv also streams every frame
+    FrameStats frameStats;
+    FrameStatsInit(&frameStats);
+    FrameStatsOpenCsvFromEnvironment(&frameStats);
+    bool showFrameStats = false;
+
     SetTargetFPS(60);
     
     while (!WindowShouldClose()) {
@@ -175,36 +95,76 @@ int main() {
         if (IsKeyPressed(KEY_TWO)) selectedPath = PATH_ANGULAR;
         if (IsKeyPressed(KEY_THREE)) selectedPath = PATH_CONVEX;
         if (IsKeyPressed(KEY_FOUR)) selectedPath = PATH_SINUSOIDAL;  // Add option for Sinusoidal path
+        if (IsKeyPressed(KEY_L)) useLut = !useLut;
+        if (IsKeyPressed(KEY_S)) useStepper = !useStepper;
+        if (IsKeyPressed(KEY_F)) showFrameStats = !showFrameStats;
+        if (IsKeyPressed(KEY_D)) {
+            constantSpeed = !constantSpeed;
+            distance = t * arcs[selectedPath].length;  // Roughly where the ball is now
+        }
+        if (useStepper && (IsKeyPressed(KEY_S) || selectedPath != stepper.path)) {
+            PathStepperInit(&stepper, selectedPath, t, 0.01f);  // Start from the current t
+        }
+        FrameStatsEndPhase(&frameStats, FRAME_PHASE_INPUT);
+
         if (IsKeyPressed(KEY_B)) {
             benchmarkOutput[0] = '\0';  // Clear the previous output
-            BenchmarkPathFunctions(benchmarkOutput);
+            BenchmarkPathFunctions(benchmarkOutput, sizeof(benchmarkOutput));
         }
         
-        if (isMoving) {
+        if (isMoving && useStepper) {
+            PathStepperStep(&stepper);
+            if (stepper.t >= 1.0f) PathStepperSeek(&stepper, 0.0f);
+            t = stepper.t;
+            ball.position = (Vector2){stepper.x, stepper.y};
+            ball.rotation += BALL_ROTATION_STEP;
+        } else if (isMoving && constantSpeed) {
+            // The same lap time as stepping t by 0.01, at an even speed
+            const PathArcTable *arc = &arcs[selectedPath];
+            distance += arc->length * 0.01f;
+            if (distance >= arc->length) distance = 0.0f;
+            t = PathArcTableT(arc, distance);
+            ball.position = pathFunctionsAsm[selectedPath](t);
+            ball.rotation += BALL_ROTATION_STEP;
+        } else if (isMoving) {
             t += 0.01f;
             if (t >= 1.0f) t = 0.0f;
-            switch (selectedPath) {
-                case PATH_STRAIGHT: ball.position = CalculateStraightPath(t); break;
-                case PATH_ANGULAR: ball.position = CalculateAngularPath(t); break;
-                case PATH_CONVEX: ball.position = CalculateConvexPath(t); break;
-                case PATH_SINUSOIDAL: ball.position = CalculateSinusoidalPath(t); break;  // Sinusoidal path
+            if (useLut) {
+                PathLutSample(&luts[selectedPath], PATH_LUT_LINEAR, t, &ball.position.x, &ball.position.y);
+            } else {
+                ball.position = pathFunctionsAsm[selectedPath](t);
             }
-            ball.rotation += 5.0f;
+            ball.rotation += BALL_ROTATION_STEP;
         }
+        FrameStatsEndPhase(&frameStats, FRAME_PHASE_UPDATE);  // Nothing collides here
         
         BeginDrawing();
         ClearBackground(RAYWHITE);
-        DrawStripedBall(ball);
+        DrawStripedBall(&ball);
         DrawText("Press 1: Straight, 2: Angular, 3: Convex, 4: Sinusoidal", 10, 10, 20, DARKGRAY);
         DrawText("Press B: Run Benchmark", 10, 40, 20, DARKGRAY);
+        DrawText(useLut ? "Press L: Lookup tables (on)" : "Press L: Lookup tables (off)", 500, 40, 20, DARKGRAY);
+        DrawText(useStepper ? "Press S: Stepper (on)" : "Press S: Stepper (off)", 500, 70, 20, DARKGRAY);
+        DrawText(constantSpeed ? "Press D: Constant speed (on)" : "Press D: Constant speed (off)", 500, 100, 20, DARKGRAY);
+        DrawText(TextFormat("Kernels: %s", cpuTierNames[GetCpuDispatch()->tier]), 500, 130, 20, DARKGRAY);
+        DrawText(showFrameStats ? "Press F: Frame statistics (on)" : "Press F: Frame statistics (off)", 500, 160, 20, DARKGRAY);
         
         if (benchmarkOutput[0] != '\0') {
             DrawText(benchmarkOutput, 10, 70, 20, DARKGRAY);  // Display benchmark results
         }
+        if (showFrameStats) DrawFrameStatsOverlay(&frameStats, SCREEN_WIDTH - FRAME_OVERLAY_WIDTH - 10, 190);
+        FrameStatsEndPhase(&frameStats, FRAME_PHASE_DRAW);
         
         EndDrawing();
+        FrameStatsEndPhase(&frameStats, FRAME_PHASE_PRESENT);
+        FrameStatsEndFrame(&frameStats);
     }
     
+    for (int path = 0; path < PATH_COUNT; path++) {
+        PathLutFree(&luts[path]);
+        PathArcTableFree(&arcs[path]);
+    }
+    FrameStatsFree(&frameStats);
     CloseWindow();
     return 0;
 }